@@ -0,0 +1,188 @@
+/*
+ * SPDX-FileCopyrightText: 2026 KSaneCore authors
+ *
+ * SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+ */
+
+/* Measures how fast the ImageBuilder decodes synthetic scan data of all
+ * supported SANE frame formats and depths. No scanner is needed. The rows
+ * ending with /perpixel decode the same data with the former per-pixel
+ * ImageBuilder, for a comparison with the specialized frame decoders. Before
+ * the measurement, every row checks that both decoders produce the same image,
+ * the autotests run the rows of the small page once for this.
+ *
+ * Usage: imagebuilderbenchmark [QtTest options] [decode:format/size/chunk]
+ * e.g. imagebuilderbenchmark decode:rgb8/a4-300dpi/64k decode:rgb8/a4-300dpi/64k/perpixel */
+
+#include "imagebuilder.h"
+#include "legacyimagebuilder.h"
+
+#include <QElapsedTimer>
+#include <QRandomGenerator>
+#include <QTest>
+
+using namespace KSaneCore;
+
+struct FrameFormat {
+    const char *name;
+    SANE_Frame format;
+    int depth;
+};
+
+struct ImageSize {
+    const char *name;
+    int width;
+    int height;
+};
+
+static SANE_Parameters frameParameters(SANE_Frame format, int depth, int width, int height, SANE_Frame frame, bool lastFrame)
+{
+    SANE_Parameters params;
+    params.format = frame;
+    params.last_frame = lastFrame ? SANE_TRUE : SANE_FALSE;
+    params.depth = depth;
+    params.pixels_per_line = width;
+    params.lines = height;
+    const int samples = format == SANE_FRAME_RGB ? 3 : 1;
+    params.bytes_per_line = depth == 1 ? (width + 7) / 8 : width * samples * (depth / 8);
+    return params;
+}
+
+static bool startPage(ImageBuilder &builder, const SANE_Parameters &params)
+{
+    return builder.start(params);
+}
+
+static bool startPage(LegacyImageBuilder &builder, const SANE_Parameters &params)
+{
+    builder.start(params);
+    return true;
+}
+
+/* Decodes one page and hands it over to page, returns false if the builder could not start the page */
+template<typename Builder>
+static bool decodePage(Builder &builder, QImage &image, SANE_Frame format, int depth, int width, int height, const QByteArray &frameData, int chunkSize, QImage &page)
+{
+    const bool threePass = format == SANE_FRAME_RED;
+    const int frames = threePass ? 3 : 1;
+    for (int frame = 0; frame < frames; frame++) {
+        const SANE_Frame frameFormat = threePass ? SANE_Frame(SANE_FRAME_RED + frame) : format;
+        const SANE_Parameters params = frameParameters(format, depth, width, height, frameFormat, frame == frames - 1);
+        if (frame == 0) {
+            if (!startPage(builder, params)) {
+                return false;
+            }
+        } else {
+            builder.beginFrame(params);
+        }
+        const auto data = reinterpret_cast<const SANE_Byte *>(frameData.constData());
+        for (qsizetype offset = 0; offset < frameData.size(); offset += chunkSize) {
+            builder.copyToImage(data + offset, int(qMin(qsizetype(chunkSize), frameData.size() - offset)));
+        }
+    }
+    builder.cropImagetoSize();
+    // the page is handed over like a finished scan, so its buffer is recycled for the next page
+    page = std::move(image);
+    return true;
+}
+
+class ImageBuilderBenchmark : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void decode_data();
+    void decode();
+};
+
+void ImageBuilderBenchmark::decode_data()
+{
+    QTest::addColumn<int>("format");
+    QTest::addColumn<int>("depth");
+    QTest::addColumn<int>("width");
+    QTest::addColumn<int>("height");
+    QTest::addColumn<int>("chunkSize");
+    QTest::addColumn<bool>("perPixel");
+
+    const FrameFormat formats[] = {
+        {"gray1", SANE_FRAME_GRAY, 1},
+        {"gray8", SANE_FRAME_GRAY, 8},
+        {"gray16", SANE_FRAME_GRAY, 16},
+        {"rgb8", SANE_FRAME_RGB, 8},
+        {"rgb16", SANE_FRAME_RGB, 16},
+        {"threepass8", SANE_FRAME_RED, 8},
+        {"threepass16", SANE_FRAME_RED, 16},
+    };
+    const ImageSize sizes[] = {
+        {"small", 850, 1100},
+        {"a4-300dpi", 2480, 3508},
+        {"a4-600dpi", 4960, 7016},
+    };
+    const int chunkSizes[] = {4 * 1024, 64 * 1024, 1024 * 1024};
+
+    for (const FrameFormat &format : formats) {
+        for (const ImageSize &size : sizes) {
+            for (int chunkSize : chunkSizes) {
+                QTest::addRow("%s/%s/%dk", format.name, size.name, chunkSize / 1024)
+                    << int(format.format) << format.depth << size.width << size.height << chunkSize << false;
+            }
+            // the per-pixel decoder hardly depends on the chunk size
+            QTest::addRow("%s/%s/64k/perpixel", format.name, size.name)
+                << int(format.format) << format.depth << size.width << size.height << 64 * 1024 << true;
+        }
+    }
+}
+
+void ImageBuilderBenchmark::decode()
+{
+    QFETCH(int, format);
+    QFETCH(int, depth);
+    QFETCH(int, width);
+    QFETCH(int, height);
+    QFETCH(int, chunkSize);
+    QFETCH(bool, perPixel);
+
+    const SANE_Frame frameFormat = SANE_Frame(format);
+    const SANE_Parameters params = frameParameters(frameFormat, depth, width, height, frameFormat, true);
+    QByteArray frameData(qsizetype(params.bytes_per_line) * params.lines, '\0');
+    QRandomGenerator random(1);
+    random.fillRange(reinterpret_cast<quint32 *>(frameData.data()), frameData.size() / sizeof(quint32));
+    const int frames = frameFormat == SANE_FRAME_RED ? 3 : 1;
+
+    QImage image;
+    QImage legacyImage;
+    int dpi = 300;
+    ImageBuilder builder(&image, &dpi);
+    LegacyImageBuilder legacyBuilder(&legacyImage, &dpi);
+    const auto decodeNextPage = [&]() {
+        QImage page;
+        if (perPixel) {
+            return decodePage(legacyBuilder, legacyImage, frameFormat, depth, width, height, frameData, chunkSize, page);
+        }
+        return decodePage(builder, image, frameFormat, depth, width, height, frameData, chunkSize, page);
+    };
+    // the first pages allocate the images and are not measured, both decoders have to produce the same image
+    {
+        QImage page;
+        QImage legacyPage;
+        QVERIFY(decodePage(builder, image, frameFormat, depth, width, height, frameData, chunkSize, page));
+        QVERIFY(decodePage(legacyBuilder, legacyImage, frameFormat, depth, width, height, frameData, chunkSize, legacyPage));
+        QCOMPARE(page, legacyPage);
+    }
+
+    int pages = 0;
+    QElapsedTimer timer;
+    timer.start();
+    QBENCHMARK {
+        decodeNextPage();
+        pages++;
+    }
+    const double seconds = timer.nsecsElapsed() / 1e9;
+    qInfo("%.1f MB/s, %.1f Mpixels/s",
+          double(frameData.size()) * frames * pages / seconds / 1e6,
+          double(width) * height * pages / seconds / 1e6);
+}
+
+QTEST_GUILESS_MAIN(ImageBuilderBenchmark)
+
+#include "imagebuilderbenchmark.moc"
@@ -0,0 +1,326 @@
+/*
+ * SPDX-FileCopyrightText: 2026 KSaneCore authors
+ *
+ * SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+ */
+
+/* Compares the images of the ImageBuilder byte for byte with the ones of the
+ * former per-pixel decoder for all SANE frame formats and depths, and the
+ * SIMD implementations of the row conversion kernels with the scalar ones. */
+
+#include "imagebuilder.h"
+#include "imagekernels.h"
+#include "legacyimagebuilder.h"
+
+#include <QRandomGenerator>
+#include <QTest>
+
+#include <cstring>
+
+using namespace KSaneCore;
+
+// the rows of every test page, the hand scanner pages do not announce them
+static constexpr int PageRows = 13;
+// the kernels are run with every length up to this one, which covers all tails of the vector loops
+static constexpr int MaxKernelUnits = 160;
+
+enum InvertMode {
+    NotInverted,
+    Inverted,
+    InvertedWhileScanning,
+};
+
+enum Kernel {
+    XorBytes,
+    Rgb8ToRgb32,
+    Rgb8ToGray8,
+    Rgb16ToRgbx64,
+    ScatterChannel8,
+    ScatterChannel16,
+};
+
+static SANE_Parameters frameParameters(SANE_Frame format, int depth, int width, int lines, SANE_Frame frame, bool lastFrame)
+{
+    SANE_Parameters params;
+    params.format = frame;
+    params.last_frame = lastFrame ? SANE_TRUE : SANE_FALSE;
+    params.depth = depth;
+    params.pixels_per_line = width;
+    params.lines = lines;
+    const int samples = format == SANE_FRAME_RGB ? 3 : 1;
+    params.bytes_per_line = depth == 1 ? (width + 7) / 8 : width * samples * (depth / 8);
+    return params;
+}
+
+static QByteArray randomBytes(QRandomGenerator &random, qsizetype size)
+{
+    QByteArray data(size, '\0');
+    for (qsizetype i = 0; i < size; i++) {
+        data[i] = char(random.bounded(256));
+    }
+    return data;
+}
+
+/* Returns the first row in which the pixels of the images differ, or -1 */
+static int firstDifferentRow(const QImage &image, const QImage &expected)
+{
+    const qsizetype rowBytes = (qsizetype(expected.width()) * expected.depth() + 7) / 8;
+    for (int y = 0; y < expected.height(); y++) {
+        if (memcmp(image.constScanLine(y), expected.constScanLine(y), rowBytes) != 0) {
+            return y;
+        }
+    }
+    return -1;
+}
+
+/* Returns the bytes per unit read and written by a kernel */
+static void kernelUnits(Kernel kernel, int *sourceBytes, int *destinationBytes)
+{
+    switch (kernel) {
+    case XorBytes:
+        *sourceBytes = 1;
+        *destinationBytes = 1;
+        break;
+    case Rgb8ToRgb32:
+        *sourceBytes = 3;
+        *destinationBytes = 4;
+        break;
+    case Rgb8ToGray8:
+        *sourceBytes = 3;
+        *destinationBytes = 1;
+        break;
+    case Rgb16ToRgbx64:
+        *sourceBytes = 6;
+        *destinationBytes = 8;
+        break;
+    case ScatterChannel8:
+        *sourceBytes = 1;
+        *destinationBytes = 4;
+        break;
+    case ScatterChannel16:
+        *sourceBytes = 2;
+        *destinationBytes = 8;
+        break;
+    }
+}
+
+static void runKernel(const ImageKernels::KernelSet &set, Kernel kernel, bool invert, int channel, const uchar *source, uchar *destination, int units)
+{
+    switch (kernel) {
+    case XorBytes:
+        // the second pattern is not the same for all bytes, so that a misplaced pattern is noticed
+        set.xorBytes(source, destination, units, invert ? ~quint64(0) : 0x0123456789ABCDEFULL);
+        break;
+    case Rgb8ToRgb32:
+        set.rgb8ToRgb32[invert](source, destination, units);
+        break;
+    case Rgb8ToGray8:
+        set.rgb8ToGray8[invert](source, destination, units);
+        break;
+    case Rgb16ToRgbx64:
+        set.rgb16ToRgbx64[invert](source, destination, units);
+        break;
+    case ScatterChannel8:
+        set.scatterChannel8[invert](source, destination, channel, units);
+        break;
+    case ScatterChannel16:
+        set.scatterChannel16[invert](source, destination, channel, units);
+        break;
+    }
+}
+
+class ImageBuilderTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void decode_data();
+    void decode();
+    void kernels_data();
+    void kernels();
+};
+
+void ImageBuilderTest::decode_data()
+{
+    QTest::addColumn<int>("format");
+    QTest::addColumn<int>("depth");
+    QTest::addColumn<int>("width");
+    QTest::addColumn<bool>("handScanner");
+    QTest::addColumn<int>("invert");
+    QTest::addColumn<bool>("directWrite");
+
+    const struct {
+        const char *name;
+        SANE_Frame format;
+        int depth;
+    } formats[] = {
+        {"gray1", SANE_FRAME_GRAY, 1},
+        {"gray8", SANE_FRAME_GRAY, 8},
+        {"gray16", SANE_FRAME_GRAY, 16},
+        {"rgb8", SANE_FRAME_RGB, 8},
+        {"rgb16", SANE_FRAME_RGB, 16},
+        {"threepass8", SANE_FRAME_RED, 8},
+        {"threepass16", SANE_FRAME_RED, 16},
+    };
+    // rows of 64 pixels have no padding in the image, so gray data can be read into it directly
+    const int widths[] = {1, 7, 64, 101};
+    const char *invertNames[] = {"normal", "inverted", "invertedwhilescanning"};
+
+    for (const auto &format : formats) {
+        for (int width : widths) {
+            for (int invert = NotInverted; invert <= InvertedWhileScanning; invert++) {
+                QTest::addRow("%s/%d/%s", format.name, width, invertNames[invert])
+                    << int(format.format) << format.depth << width << false << invert << false;
+                if (format.format == SANE_FRAME_RED) {
+                    continue;
+                }
+                QTest::addRow("%s/%d/%s/handscanner", format.name, width, invertNames[invert])
+                    << int(format.format) << format.depth << width << true << invert << false;
+                if (format.format == SANE_FRAME_GRAY && format.depth != 16) {
+                    QTest::addRow("%s/%d/%s/directwrite", format.name, width, invertNames[invert])
+                        << int(format.format) << format.depth << width << false << invert << true;
+                }
+            }
+        }
+    }
+}
+
+void ImageBuilderTest::decode()
+{
+    QFETCH(int, format);
+    QFETCH(int, depth);
+    QFETCH(int, width);
+    QFETCH(bool, handScanner);
+    QFETCH(int, invert);
+    QFETCH(bool, directWrite);
+
+    const SANE_Frame frameFormat = SANE_Frame(format);
+    const bool threePass = frameFormat == SANE_FRAME_RED;
+    const int frames = threePass ? 3 : 1;
+    const int lines = handScanner ? -1 : PageRows;
+    QRandomGenerator random(quint32(format * 1000 + depth * 100 + width));
+
+    QList<SANE_Parameters> params;
+    QList<QByteArray> frameData;
+    for (int frame = 0; frame < frames; frame++) {
+        const SANE_Frame frameType = threePass ? SANE_Frame(SANE_FRAME_RED + frame) : frameFormat;
+        params.append(frameParameters(frameFormat, depth, width, lines, frameType, frame == frames - 1));
+        frameData.append(randomBytes(random, qsizetype(params.last().bytes_per_line) * PageRows));
+    }
+
+    // the reference decoder cannot invert, so it decodes the inverted data instead
+    QImage expected;
+    int dpi = 300;
+    LegacyImageBuilder reference(&expected, &dpi);
+    for (int frame = 0; frame < frames; frame++) {
+        if (frame == 0) {
+            reference.start(params[frame]);
+        } else {
+            reference.beginFrame(params[frame]);
+        }
+        QByteArray data = frameData[frame];
+        if (invert != NotInverted) {
+            for (char &byte : data) {
+                byte = char(~byte);
+            }
+        }
+        reference.copyToImage(reinterpret_cast<const SANE_Byte *>(data.constData()), int(data.size()));
+    }
+    reference.cropImagetoSize();
+
+    // the data arrives in chunks of random sizes which split pixels, samples and rows
+    QImage image;
+    ImageBuilder builder(&image, &dpi);
+    builder.setInvertColors(invert == Inverted);
+    const qsizetype totalBytes = frameData.first().size() * frames;
+    qsizetype fedBytes = 0;
+    for (int frame = 0; frame < frames; frame++) {
+        if (frame == 0) {
+            QVERIFY(builder.start(params[frame]));
+        } else {
+            builder.beginFrame(params[frame]);
+        }
+        const auto data = reinterpret_cast<const SANE_Byte *>(frameData[frame].constData());
+        const qsizetype frameBytes = frameData[frame].size();
+        qsizetype offset = 0;
+        while (offset < frameBytes) {
+            if (invert == InvertedWhileScanning && fedBytes >= totalBytes / 2) {
+                builder.setInvertColors(true);
+            }
+            int chunkSize = int(qMin(qsizetype(random.bounded(1, 3 * params[frame].bytes_per_line + 1)), frameBytes - offset));
+            SANE_Byte *buffer = directWrite ? builder.directWriteBuffer(&chunkSize) : nullptr;
+            if (buffer != nullptr) {
+                memcpy(buffer, data + offset, chunkSize);
+                builder.commitDirectWrite(chunkSize);
+            } else {
+                QVERIFY(builder.copyToImage(data + offset, chunkSize));
+            }
+            offset += chunkSize;
+            fedBytes += chunkSize;
+        }
+    }
+    QVERIFY(builder.cropImagetoSize());
+
+    QCOMPARE(image.format(), expected.format());
+    QCOMPARE(image.width(), expected.width());
+    QCOMPARE(image.height(), PageRows);
+    QCOMPARE(expected.height(), PageRows);
+    QCOMPARE(firstDifferentRow(image, expected), -1);
+}
+
+void ImageBuilderTest::kernels_data()
+{
+    QTest::addColumn<int>("kernel");
+
+    QTest::newRow("xorBytes") << int(XorBytes);
+    QTest::newRow("rgb8ToRgb32") << int(Rgb8ToRgb32);
+    QTest::newRow("rgb8ToGray8") << int(Rgb8ToGray8);
+    QTest::newRow("rgb16ToRgbx64") << int(Rgb16ToRgbx64);
+    QTest::newRow("scatterChannel8") << int(ScatterChannel8);
+    QTest::newRow("scatterChannel16") << int(ScatterChannel16);
+}
+
+void ImageBuilderTest::kernels()
+{
+    QFETCH(int, kernel);
+
+    const QList<ImageKernels::KernelSet> sets = ImageKernels::kernelSets();
+    if (sets.size() < 2) {
+        QSKIP("The CPU supports only the scalar kernels");
+    }
+    const ImageKernels::KernelSet &scalar = sets.first();
+    int sourceBytes = 0;
+    int destinationBytes = 0;
+    kernelUnits(Kernel(kernel), &sourceBytes, &destinationBytes);
+    const bool scatter = kernel == ScatterChannel8 || kernel == ScatterChannel16;
+    QRandomGenerator random(kernel);
+
+    for (int i = 1; i < sets.size(); i++) {
+        const ImageKernels::KernelSet &set = sets.at(i);
+        for (int invert = 0; invert < 2; invert++) {
+            for (int channel = 0; channel < (scatter ? 3 : 1); channel++) {
+                for (int units = 0; units <= MaxKernelUnits; units++) {
+                    // the samples are read unaligned, the bytes behind the pixels have to stay untouched
+                    const QByteArray source = randomBytes(random, qsizetype(units) * sourceBytes + 1);
+                    QByteArray expected = randomBytes(random, qsizetype(units) * destinationBytes + 8);
+                    QByteArray result = expected;
+                    runKernel(scalar, Kernel(kernel), invert, channel, reinterpret_cast<const uchar *>(source.constData()) + 1,
+                              reinterpret_cast<uchar *>(expected.data()), units);
+                    runKernel(set, Kernel(kernel), invert, channel, reinterpret_cast<const uchar *>(source.constData()) + 1,
+                              reinterpret_cast<uchar *>(result.data()), units);
+                    if (result != expected) {
+                        QFAIL(qPrintable(QStringLiteral("%1 differs from the scalar kernel with %2 units, invert %3 and channel %4")
+                                             .arg(QLatin1String(set.name))
+                                             .arg(units)
+                                             .arg(invert)
+                                             .arg(channel)));
+                    }
+                }
+            }
+        }
+    }
+}
+
+QTEST_GUILESS_MAIN(ImageBuilderTest)
+
+#include "imagebuildertest.moc"
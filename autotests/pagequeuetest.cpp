@@ -0,0 +1,81 @@
+/*
+ * SPDX-FileCopyrightText: 2026 KSaneCore authors
+ *
+ * SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+ */
+
+#include "fakesane.h"
+#include "interface.h"
+#include "option.h"
+
+#include <QSignalSpy>
+#include <QTest>
+#include <QThread>
+
+using namespace KSaneCore;
+
+static constexpr int FeederPages = 5;
+
+class PageQueueTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+    void pageQueueDepth_data();
+    void pageQueueDepth();
+};
+
+void PageQueueTest::initTestCase()
+{
+    FakeSane::Config config;
+    config.lines = 20;
+    config.feederPages = FeederPages;
+    FakeSane::setConfig(config);
+}
+
+void PageQueueTest::pageQueueDepth_data()
+{
+    QTest::addColumn<int>("depth");
+
+    QTest::newRow("0") << 0;
+    QTest::newRow("1") << 1;
+    QTest::newRow("2") << 2;
+}
+
+void PageQueueTest::pageQueueDepth()
+{
+    QFETCH(int, depth);
+
+    Interface interface;
+    QCOMPARE(interface.openDevice(QStringLiteral("fake")), Interface::OpeningSucceeded);
+    Option *source = interface.getOption(Interface::SourceOption);
+    QVERIFY(source != nullptr);
+    QVERIFY(source->setValue(QStringLiteral("Automatic Document Feeder")));
+    interface.setPageQueueDepth(depth);
+
+    int pages = 0;
+    int startedWhileHandled = -1;
+    connect(&interface, &Interface::scannedImageReady, this, [&pages, &startedWhileHandled]() {
+        pages++;
+        if (pages == 1) {
+            // the application is busy with the first page, the worker scans ahead until the queue is full
+            QThread::msleep(500);
+            startedWhileHandled = FakeSane::startedPages();
+        }
+    });
+    QSignalSpy finished(&interface, &Interface::scanFinished);
+
+    interface.startScan();
+    QVERIFY(finished.wait(10000));
+    // besides the page which is handled, depth following pages have been scanned ahead
+    QCOMPARE(startedWhileHandled, depth + 1);
+    // the feeder continues once the pages are handled, until it is empty
+    QCOMPARE(pages, FeederPages);
+
+    interface.closeDevice();
+}
+
+QTEST_GUILESS_MAIN(PageQueueTest)
+
+#include "pagequeuetest.moc"
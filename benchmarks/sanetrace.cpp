@@ -0,0 +1,169 @@
+/*
+ * SPDX-FileCopyrightText: 2026 KSaneCore authors
+ *
+ * SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+ */
+
+#include "sanetrace.h"
+
+#include <QDataStream>
+#include <QFile>
+
+namespace SaneTrace
+{
+
+bool Record::changesState() const
+{
+    switch (call) {
+    case Call::GetDevices:
+    case Call::GetOptionDescriptor:
+    case Call::GetParameters:
+    case Call::GetSelectFd:
+        return false;
+    case Call::ControlOption:
+        return action != SANE_ACTION_GET_VALUE;
+    default:
+        return true;
+    }
+}
+
+void setDescriptor(Record &record, const SANE_Option_Descriptor *descriptor)
+{
+    record.strings.clear();
+    record.words.clear();
+    if (descriptor == nullptr) {
+        return;
+    }
+    record.strings = {QByteArray(descriptor->name), QByteArray(descriptor->title), QByteArray(descriptor->desc)};
+    record.words = {descriptor->type, descriptor->unit, descriptor->size, descriptor->cap, descriptor->constraint_type};
+    switch (descriptor->constraint_type) {
+    case SANE_CONSTRAINT_RANGE:
+        record.words << descriptor->constraint.range->min << descriptor->constraint.range->max << descriptor->constraint.range->quant;
+        break;
+    case SANE_CONSTRAINT_WORD_LIST:
+        // the first word is the number of words that follow
+        for (int i = 0; i <= descriptor->constraint.word_list[0]; i++) {
+            record.words << descriptor->constraint.word_list[i];
+        }
+        break;
+    case SANE_CONSTRAINT_STRING_LIST:
+        for (int i = 0; descriptor->constraint.string_list[i] != nullptr; i++) {
+            record.strings << QByteArray(descriptor->constraint.string_list[i]);
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+void setParameters(Record &record, const SANE_Parameters &params)
+{
+    record.words = {params.format, params.last_frame, params.bytes_per_line, params.pixels_per_line, params.lines, params.depth};
+}
+
+SANE_Parameters parameters(const Record &record)
+{
+    SANE_Parameters params = {};
+    if (record.words.size() == 6) {
+        params.format = SANE_Frame(record.words[0]);
+        params.last_frame = record.words[1];
+        params.bytes_per_line = record.words[2];
+        params.pixels_per_line = record.words[3];
+        params.lines = record.words[4];
+        params.depth = record.words[5];
+    }
+    return params;
+}
+
+const char *callName(Call call)
+{
+    switch (call) {
+    case Call::Init:
+        return "sane_init";
+    case Call::Exit:
+        return "sane_exit";
+    case Call::GetDevices:
+        return "sane_get_devices";
+    case Call::Open:
+        return "sane_open";
+    case Call::Close:
+        return "sane_close";
+    case Call::GetOptionDescriptor:
+        return "sane_get_option_descriptor";
+    case Call::ControlOption:
+        return "sane_control_option";
+    case Call::GetParameters:
+        return "sane_get_parameters";
+    case Call::Start:
+        return "sane_start";
+    case Call::Read:
+        return "sane_read";
+    case Call::Cancel:
+        return "sane_cancel";
+    case Call::SetIoMode:
+        return "sane_set_io_mode";
+    case Call::GetSelectFd:
+        return "sane_get_select_fd";
+    }
+    return "unknown";
+}
+
+QDataStream &operator<<(QDataStream &stream, const Record &record)
+{
+    stream << quint8(record.call) << record.start << record.duration << record.status;
+    stream << record.option << record.action << record.info << record.value;
+    stream << record.data << record.dataOut << record.strings << record.words;
+    return stream;
+}
+
+QDataStream &operator>>(QDataStream &stream, Record &record)
+{
+    quint8 call;
+    stream >> call >> record.start >> record.duration >> record.status;
+    stream >> record.option >> record.action >> record.info >> record.value;
+    stream >> record.data >> record.dataOut >> record.strings >> record.words;
+    record.call = Call(call);
+    if (call > quint8(Call::GetSelectFd)) {
+        stream.setStatus(QDataStream::ReadCorruptData);
+    }
+    return stream;
+}
+
+void writeHeader(QDataStream &stream)
+{
+    stream.setVersion(QDataStream::Qt_6_0);
+    stream << Magic << Version;
+}
+
+bool readTrace(const QString &fileName, QList<Record> *records, QString *error)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly)) {
+        *error = file.errorString();
+        return false;
+    }
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_6_0);
+    quint32 magic;
+    quint32 version;
+    stream >> magic >> version;
+    if (magic != Magic || version != Version) {
+        *error = QStringLiteral("not a SANE trace of version %1").arg(Version);
+        return false;
+    }
+
+    records->clear();
+    while (!stream.atEnd()) {
+        Record record;
+        stream >> record;
+        if (stream.status() != QDataStream::Ok) {
+            // a recording which has been interrupted ends with an incomplete record
+            *error = QStringLiteral("the trace is truncated after %1 calls").arg(records->size());
+            return !records->isEmpty();
+        }
+        records->append(record);
+    }
+    return true;
+}
+
+} // namespace SaneTrace
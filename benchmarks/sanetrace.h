@@ -0,0 +1,92 @@
+/*
+ * SPDX-FileCopyrightText: 2026 KSaneCore authors
+ *
+ * SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+ */
+
+#ifndef KSANE_SANE_TRACE_H
+#define KSANE_SANE_TRACE_H
+
+#include <QByteArray>
+#include <QList>
+#include <QString>
+
+extern "C"
+{
+#include <sane/sane.h>
+}
+
+class QDataStream;
+
+/* A trace of the SANE calls of a session, recorded with the arguments, the
+ * returned data and the time each call took.
+ *
+ * A trace file starts with the magic number and the version, followed by
+ * one record per call in the order the calls returned. */
+namespace SaneTrace
+{
+
+constexpr quint32 Magic = 0x4b535452; // "KSTR"
+constexpr quint32 Version = 1;
+
+enum class Call : quint8 {
+    Init,
+    Exit,
+    GetDevices,
+    Open,
+    Close,
+    GetOptionDescriptor,
+    ControlOption,
+    GetParameters,
+    Start,
+    Read,
+    Cancel,
+    SetIoMode,
+    GetSelectFd,
+};
+
+struct Record {
+    Call call = Call::Init;
+    // start of the call since sane_init() and its duration, in nanoseconds
+    qint64 start = 0;
+    qint64 duration = 0;
+    qint32 status = SANE_STATUS_GOOD;
+    // option calls: the option, the action and the returned info flags
+    qint32 option = -1;
+    qint32 action = SANE_ACTION_GET_VALUE;
+    qint32 info = 0;
+    // version code, maximum read length, local only or non-blocking flag or select fd
+    qint32 value = 0;
+    // the device name, the value passed to sane_control_option() or the data read
+    QByteArray data;
+    // the value returned by sane_control_option()
+    QByteArray dataOut;
+    // four strings per device, or name, title, description and string list of an option
+    QList<QByteArray> strings;
+    // type, unit, size, capabilities, constraint type and constraint of an option,
+    // or the frame parameters
+    QList<qint32> words;
+
+    /* Whether the call changes the state of the device, other calls only query it */
+    bool changesState() const;
+};
+
+/* Conversions between the SANE structures and the fields of a record */
+void setDescriptor(Record &record, const SANE_Option_Descriptor *descriptor);
+void setParameters(Record &record, const SANE_Parameters &params);
+SANE_Parameters parameters(const Record &record);
+
+const char *callName(Call call);
+
+QDataStream &operator<<(QDataStream &stream, const Record &record);
+QDataStream &operator>>(QDataStream &stream, Record &record);
+
+/* Writes the header of a trace file */
+void writeHeader(QDataStream &stream);
+
+/* Reads a whole trace file, returns false and sets the error if it cannot be read */
+bool readTrace(const QString &fileName, QList<Record> *records, QString *error);
+
+} // namespace SaneTrace
+
+#endif // KSANE_SANE_TRACE_H
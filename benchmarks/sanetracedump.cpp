@@ -0,0 +1,121 @@
+/*
+ * SPDX-FileCopyrightText: 2026 KSaneCore authors
+ *
+ * SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+ */
+
+/* Prints a SANE trace recorded with the sanetrace library, one line per
+ * call, followed by the number and the durations of the calls per function.
+ *
+ * Usage: sanetracedump [--summary] session.trace */
+
+#include "sanetrace.h"
+
+#include <QList>
+#include <QMap>
+#include <QString>
+#include <QTextStream>
+
+using namespace SaneTrace;
+
+struct CallSummary {
+    int count = 0;
+    qint64 total = 0;
+    qint64 maximum = 0;
+    qint64 bytes = 0;
+};
+
+static QString milliseconds(qint64 nsecs)
+{
+    return QString::number(nsecs / 1e6, 'f', 3);
+}
+
+static QString details(const Record &record)
+{
+    switch (record.call) {
+    case Call::Init:
+        return QStringLiteral("version 0x%1").arg(quint32(record.value), 8, 16, QLatin1Char('0'));
+    case Call::GetDevices:
+        return QStringLiteral("%1 devices").arg(record.strings.size() / 4);
+    case Call::Open:
+        return QString::fromUtf8(record.data);
+    case Call::GetOptionDescriptor:
+        return QStringLiteral("option %1 %2").arg(record.option).arg(QString::fromUtf8(record.strings.value(0)));
+    case Call::ControlOption:
+        return QStringLiteral("option %1 action %2 %3 bytes info 0x%4").arg(record.option).arg(record.action).arg(record.dataOut.size()).arg(record.info, 0, 16);
+    case Call::GetParameters: {
+        const SANE_Parameters params = parameters(record);
+        return QStringLiteral("format %1 last %2 %3x%4 depth %5 bytes per line %6")
+            .arg(params.format)
+            .arg(params.last_frame)
+            .arg(params.pixels_per_line)
+            .arg(params.lines)
+            .arg(params.depth)
+            .arg(params.bytes_per_line);
+    }
+    case Call::Read:
+        return QStringLiteral("%1 of %2 bytes").arg(record.data.size()).arg(record.value);
+    case Call::SetIoMode:
+        return record.value ? QStringLiteral("non-blocking") : QStringLiteral("blocking");
+    case Call::GetSelectFd:
+        return QStringLiteral("fd %1").arg(record.value);
+    default:
+        return QString();
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    QTextStream out(stdout);
+    QTextStream err(stderr);
+
+    const bool summaryOnly = argc > 2 && qstrcmp(argv[1], "--summary") == 0;
+    if (argc != (summaryOnly ? 3 : 2)) {
+        err << "Usage: sanetracedump [--summary] session.trace\n";
+        return 1;
+    }
+
+    QList<Record> records;
+    QString error;
+    const QString fileName = QString::fromLocal8Bit(argv[argc - 1]);
+    if (!readTrace(fileName, &records, &error)) {
+        err << fileName << ": " << error << "\n";
+        return 1;
+    }
+    if (!error.isEmpty()) {
+        err << fileName << ": " << error << "\n";
+    }
+
+    QMap<int, CallSummary> summaries;
+    for (const Record &record : records) {
+        if (!summaryOnly) {
+            out << QStringLiteral("%1 %2 %3 %4 %5\n")
+                       .arg(milliseconds(record.start), 12)
+                       .arg(milliseconds(record.duration), 10)
+                       .arg(QLatin1String(callName(record.call)), -27)
+                       .arg(record.status, 2)
+                       .arg(details(record));
+        }
+        CallSummary &summary = summaries[int(record.call)];
+        summary.count++;
+        summary.total += record.duration;
+        summary.maximum = qMax(summary.maximum, record.duration);
+        summary.bytes += record.data.size();
+    }
+
+    out << QStringLiteral("\n%1 %2 %3 %4 %5\n")
+               .arg(QStringLiteral("function"), -27)
+               .arg(QStringLiteral("calls"), 8)
+               .arg(QStringLiteral("total ms"), 12)
+               .arg(QStringLiteral("max ms"), 10)
+               .arg(QStringLiteral("bytes"), 12);
+    for (auto it = summaries.cbegin(); it != summaries.cend(); ++it) {
+        out << QStringLiteral("%1 %2 %3 %4 %5\n")
+                   .arg(QLatin1String(callName(Call(it.key()))), -27)
+                   .arg(it->count, 8)
+                   .arg(milliseconds(it->total), 12)
+                   .arg(milliseconds(it->maximum), 10)
+                   .arg(it->bytes, 12);
+    }
+    return 0;
+}
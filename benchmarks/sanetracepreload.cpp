@@ -0,0 +1,689 @@
+/*
+ * SPDX-FileCopyrightText: 2026 KSaneCore authors
+ *
+ * SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+ */
+
+/* Records the SANE calls of an application to a trace file or replays a
+ * recorded trace without the scanner. The library is preloaded in front of
+ * libsane, so every call made by KSaneCore passes through it:
+ *
+ *   KSANECORE_SANE_RECORD=session.trace LD_PRELOAD=libksanecore_sanetrace.so skanlite
+ *   KSANECORE_SANE_REPLAY=session.trace LD_PRELOAD=libksanecore_sanetrace.so skanlite
+ *
+ * The replay waits as long as the recorded calls took, divided by the factor
+ * in KSANECORE_SANE_REPLAY_SPEED, 0 replays without waiting.
+ *
+ * The calls of a replay do not need to repeat the recording exactly. Calls
+ * which change the state of the device are matched with the next recorded
+ * call of the same kind, queries are answered with the recorded result for
+ * the current state. sane_read() returns the recorded data in the recorded
+ * portions, split further if the application reads less. */
+
+#include "sanetrace.h"
+
+#include <QByteArray>
+#include <QDataStream>
+#include <QDeadlineTimer>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QHash>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QWaitCondition>
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <dlfcn.h>
+#include <memory>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+using namespace SaneTrace;
+
+namespace
+{
+
+enum class Mode {
+    PassThrough,
+    Record,
+    Replay,
+};
+
+/* An option descriptor of a replayed trace, pointing into the strings of its record */
+struct ReplayDescriptor {
+    SANE_Option_Descriptor descriptor;
+    SANE_Range range;
+    std::vector<SANE_String_Const> stringList;
+};
+
+/* A device list of a replayed trace */
+struct ReplayDevices {
+    std::vector<SANE_Device> devices;
+    std::vector<const SANE_Device *> list;
+};
+
+struct Session {
+    QMutex mutex;
+    Mode mode = Mode::PassThrough;
+    QElapsedTimer clock;
+
+    // recording
+    QFile file;
+    QDataStream stream;
+
+    // replay
+    QList<Record> records;
+    // for each record, the first record from there on which changes the state
+    std::vector<int> nextChange;
+    QHash<int, std::shared_ptr<ReplayDescriptor>> descriptors;
+    QHash<int, std::shared_ptr<ReplayDevices>> deviceLists;
+    double speed = 1;
+    // the recorded calls before this one have been replayed
+    int position = 0;
+    // a read whose data has been returned in part
+    int pendingRead = -1;
+    qsizetype pendingOffset = 0;
+    bool cancelled = false;
+    QWaitCondition cancelCondition;
+    int selectPipe[2] = {-1, -1};
+};
+
+Session s_session;
+
+template<typename Function>
+Function realFunction(const char *name)
+{
+    return reinterpret_cast<Function>(dlsym(RTLD_NEXT, name));
+}
+
+#define REAL_FUNCTION(function) realFunction<decltype(&function)>(#function)
+
+/* Records a call from its construction until finish() */
+struct CallRecord {
+    explicit CallRecord(Call call)
+    {
+        record.call = call;
+        record.start = s_session.clock.nsecsElapsed();
+    }
+
+    void finish(SANE_Status status)
+    {
+        record.duration = s_session.clock.nsecsElapsed() - record.start;
+        record.status = status;
+        QMutexLocker locker(&s_session.mutex);
+        s_session.stream << record;
+        // keep the trace of a session which does not end properly, page by page
+        if (record.call != Call::Read && record.changesState()) {
+            s_session.file.flush();
+        }
+    }
+
+    Record record;
+};
+
+void setUpReplay(const QString &fileName)
+{
+    QString error;
+    if (!readTrace(fileName, &s_session.records, &error)) {
+        qWarning("Cannot replay the SANE trace %s: %s", qPrintable(fileName), qPrintable(error));
+        return;
+    }
+    if (!error.isEmpty()) {
+        qWarning("SANE trace %s: %s", qPrintable(fileName), qPrintable(error));
+    }
+
+    const QList<Record> &records = s_session.records;
+    s_session.nextChange.resize(records.size() + 1);
+    s_session.nextChange[records.size()] = records.size();
+    for (int i = records.size() - 1; i >= 0; i--) {
+        s_session.nextChange[i] = records[i].changesState() ? i : s_session.nextChange[i + 1];
+    }
+
+    for (int i = 0; i < records.size(); i++) {
+        const Record &record = records[i];
+        if (record.call == Call::GetOptionDescriptor && record.words.size() >= 5 && record.strings.size() >= 3) {
+            auto replay = std::make_shared<ReplayDescriptor>();
+            SANE_Option_Descriptor &descriptor = replay->descriptor;
+            descriptor.name = record.strings[0].constData();
+            descriptor.title = record.strings[1].constData();
+            descriptor.desc = record.strings[2].constData();
+            descriptor.type = SANE_Value_Type(record.words[0]);
+            descriptor.unit = SANE_Unit(record.words[1]);
+            descriptor.size = record.words[2];
+            descriptor.cap = record.words[3];
+            descriptor.constraint_type = SANE_Constraint_Type(record.words[4]);
+            if (descriptor.constraint_type == SANE_CONSTRAINT_RANGE && record.words.size() == 8) {
+                replay->range = {record.words[5], record.words[6], record.words[7]};
+                descriptor.constraint.range = &replay->range;
+            } else if (descriptor.constraint_type == SANE_CONSTRAINT_WORD_LIST && record.words.size() > 5) {
+                descriptor.constraint.word_list = record.words.constData() + 5;
+            } else if (descriptor.constraint_type == SANE_CONSTRAINT_STRING_LIST) {
+                for (int j = 3; j < record.strings.size(); j++) {
+                    replay->stringList.push_back(record.strings[j].constData());
+                }
+                replay->stringList.push_back(nullptr);
+                descriptor.constraint.string_list = replay->stringList.data();
+            } else {
+                descriptor.constraint_type = SANE_CONSTRAINT_NONE;
+            }
+            s_session.descriptors.insert(i, replay);
+        } else if (record.call == Call::GetDevices) {
+            auto replay = std::make_shared<ReplayDevices>();
+            for (int j = 0; j + 3 < record.strings.size(); j += 4) {
+                replay->devices.push_back({record.strings[j].constData(),
+                                           record.strings[j + 1].constData(),
+                                           record.strings[j + 2].constData(),
+                                           record.strings[j + 3].constData()});
+            }
+            for (const SANE_Device &device : replay->devices) {
+                replay->list.push_back(&device);
+            }
+            replay->list.push_back(nullptr);
+            s_session.deviceLists.insert(i, replay);
+        }
+    }
+
+    bool ok;
+    const double speed = qEnvironmentVariable("KSANECORE_SANE_REPLAY_SPEED").toDouble(&ok);
+    if (ok && speed >= 0) {
+        s_session.speed = speed;
+    }
+    s_session.mode = Mode::Replay;
+}
+
+void setUp()
+{
+    static bool setUpDone = false;
+    if (setUpDone) {
+        return;
+    }
+    setUpDone = true;
+    s_session.clock.start();
+
+    const QString replayFile = qEnvironmentVariable("KSANECORE_SANE_REPLAY");
+    if (!replayFile.isEmpty()) {
+        setUpReplay(replayFile);
+        return;
+    }
+    const QString recordFile = qEnvironmentVariable("KSANECORE_SANE_RECORD");
+    if (!recordFile.isEmpty()) {
+        s_session.file.setFileName(recordFile);
+        if (!s_session.file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+            qWarning("Cannot record the SANE trace %s: %s", qPrintable(recordFile), qPrintable(s_session.file.errorString()));
+            return;
+        }
+        s_session.stream.setDevice(&s_session.file);
+        writeHeader(s_session.stream);
+        s_session.mode = Mode::Record;
+    }
+}
+
+bool matches(const Record &record, Call call, int option, int action)
+{
+    if (record.call != call) {
+        return false;
+    }
+    if (call == Call::GetOptionDescriptor) {
+        return record.option == option;
+    }
+    if (call == Call::ControlOption) {
+        return record.option == option && record.action == action;
+    }
+    return true;
+}
+
+/* Finds the recorded result of a query in the current state of the device.
+ * Called with the mutex locked. */
+int findQuery(Call call, int option = -1, int action = SANE_ACTION_GET_VALUE)
+{
+    const QList<Record> &records = s_session.records;
+    for (int i = s_session.position; i < s_session.nextChange[s_session.position]; i++) {
+        if (matches(records[i], call, option, action)) {
+            return i;
+        }
+    }
+    // the state has not changed since the last recorded query
+    for (int i = qMin(s_session.position, int(records.size())) - 1; i >= 0; i--) {
+        if (matches(records[i], call, option, action)) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+/* Finds the next recorded call which changes the state and replays the calls up to it.
+ * Called with the mutex locked. */
+int findChange(Call call, int option = -1, int action = SANE_ACTION_GET_VALUE)
+{
+    const QList<Record> &records = s_session.records;
+    for (int i = s_session.position; i < records.size(); i++) {
+        if (matches(records[i], call, option, action)) {
+            if (s_session.nextChange[s_session.position] < i) {
+                qWarning("SANE replay: %s skips recorded calls from %d to %d", callName(call), s_session.nextChange[s_session.position], i);
+            }
+            s_session.position = i + 1;
+            return i;
+        }
+    }
+    qWarning("SANE replay: %s is not recorded after call %d", callName(call), s_session.position);
+    return -1;
+}
+
+/* Takes as long as the recorded call, called with the mutex locked */
+void waitRecorded(QMutexLocker<QMutex> &locker, qint64 duration)
+{
+    if (s_session.speed <= 0) {
+        return;
+    }
+    locker.unlock();
+    std::this_thread::sleep_for(std::chrono::nanoseconds(qint64(duration / s_session.speed)));
+    locker.relock();
+}
+
+/* Takes as long as the recorded call unless the scan is cancelled, returns false if it is.
+ * Called with the mutex locked. */
+bool waitRecordedUncancelled(qint64 duration)
+{
+    if (s_session.speed > 0) {
+        const QDeadlineTimer deadline(std::chrono::nanoseconds(qint64(duration / s_session.speed)));
+        while (!s_session.cancelled && !deadline.hasExpired()) {
+            s_session.cancelCondition.wait(&s_session.mutex, deadline);
+        }
+    }
+    return !s_session.cancelled;
+}
+
+SANE_Status replayRead(SANE_Byte *data, SANE_Int max_length, SANE_Int *length)
+{
+    *length = 0;
+    QMutexLocker locker(&s_session.mutex);
+    if (s_session.cancelled) {
+        s_session.pendingRead = -1;
+        return SANE_STATUS_CANCELLED;
+    }
+    if (s_session.pendingRead < 0) {
+        int index;
+        do {
+            index = findChange(Call::Read);
+            // reads of the non-blocking mode which found no data are left out
+        } while (index >= 0 && s_session.records[index].status == SANE_STATUS_GOOD && s_session.records[index].data.isEmpty());
+        if (index < 0) {
+            return SANE_STATUS_IO_ERROR;
+        }
+        s_session.pendingRead = index;
+        s_session.pendingOffset = 0;
+    }
+
+    const Record &record = s_session.records[s_session.pendingRead];
+    if (record.status != SANE_STATUS_GOOD) {
+        s_session.pendingRead = -1;
+        if (!waitRecordedUncancelled(record.duration)) {
+            return SANE_STATUS_CANCELLED;
+        }
+        return SANE_Status(record.status);
+    }
+
+    const qsizetype bytes = std::min(qsizetype(qMax(max_length, 0)), record.data.size() - s_session.pendingOffset);
+    const qsizetype offset = s_session.pendingOffset;
+    s_session.pendingOffset += bytes;
+    if (s_session.pendingOffset >= record.data.size()) {
+        s_session.pendingRead = -1;
+    }
+    if (!waitRecordedUncancelled(record.duration * bytes / record.data.size())) {
+        s_session.pendingRead = -1;
+        return SANE_STATUS_CANCELLED;
+    }
+    memcpy(data, record.data.constData() + offset, bytes);
+    *length = SANE_Int(bytes);
+    return SANE_STATUS_GOOD;
+}
+
+SANE_Status replayControlOption(SANE_Int option, SANE_Action action, void *value, SANE_Int *info)
+{
+    QMutexLocker locker(&s_session.mutex);
+    const int index = action == SANE_ACTION_GET_VALUE ? findQuery(Call::ControlOption, option, action) : findChange(Call::ControlOption, option, action);
+    if (index < 0) {
+        return SANE_STATUS_INVAL;
+    }
+    const Record &record = s_session.records[index];
+    waitRecorded(locker, record.duration);
+    if (value != nullptr) {
+        memcpy(value, record.dataOut.constData(), record.dataOut.size());
+    }
+    if (info != nullptr) {
+        *info = record.info;
+    }
+    return SANE_Status(record.status);
+}
+
+/* Replays a call without results other than its status */
+SANE_Status replayStatus(Call call)
+{
+    QMutexLocker locker(&s_session.mutex);
+    const int index = findChange(call);
+    if (index < 0) {
+        return SANE_STATUS_IO_ERROR;
+    }
+    waitRecorded(locker, s_session.records[index].duration);
+    return SANE_Status(s_session.records[index].status);
+}
+
+} // namespace
+
+extern "C" {
+
+Q_DECL_EXPORT SANE_Status sane_init(SANE_Int *version_code, SANE_Auth_Callback authorize)
+{
+    static const auto real = REAL_FUNCTION(sane_init);
+    setUp();
+    if (s_session.mode == Mode::Replay) {
+        QMutexLocker locker(&s_session.mutex);
+        const int index = findChange(Call::Init);
+        if (index < 0) {
+            return SANE_STATUS_IO_ERROR;
+        }
+        if (version_code != nullptr) {
+            *version_code = s_session.records[index].value;
+        }
+        return SANE_Status(s_session.records[index].status);
+    }
+    if (s_session.mode == Mode::PassThrough) {
+        return real(version_code, authorize);
+    }
+    CallRecord call(Call::Init);
+    SANE_Int version = 0;
+    const SANE_Status status = real(&version, authorize);
+    if (version_code != nullptr) {
+        *version_code = version;
+    }
+    call.record.value = version;
+    call.finish(status);
+    return status;
+}
+
+Q_DECL_EXPORT void sane_exit(void)
+{
+    static const auto real = REAL_FUNCTION(sane_exit);
+    if (s_session.mode == Mode::Replay) {
+        replayStatus(Call::Exit);
+        return;
+    }
+    if (s_session.mode == Mode::PassThrough) {
+        real();
+        return;
+    }
+    CallRecord call(Call::Exit);
+    real();
+    call.finish(SANE_STATUS_GOOD);
+}
+
+Q_DECL_EXPORT SANE_Status sane_get_devices(const SANE_Device ***device_list, SANE_Bool local_only)
+{
+    static const auto real = REAL_FUNCTION(sane_get_devices);
+    if (s_session.mode == Mode::Replay) {
+        static const SANE_Device *noDevices[] = {nullptr};
+        QMutexLocker locker(&s_session.mutex);
+        const int index = findQuery(Call::GetDevices);
+        if (index < 0) {
+            *device_list = noDevices;
+            return SANE_STATUS_GOOD;
+        }
+        waitRecorded(locker, s_session.records[index].duration);
+        *device_list = s_session.deviceLists.value(index)->list.data();
+        return SANE_Status(s_session.records[index].status);
+    }
+    if (s_session.mode == Mode::PassThrough) {
+        return real(device_list, local_only);
+    }
+    CallRecord call(Call::GetDevices);
+    const SANE_Status status = real(device_list, local_only);
+    call.record.value = local_only;
+    if (status == SANE_STATUS_GOOD) {
+        for (int i = 0; (*device_list)[i] != nullptr; i++) {
+            const SANE_Device *device = (*device_list)[i];
+            call.record.strings << QByteArray(device->name) << QByteArray(device->vendor) << QByteArray(device->model) << QByteArray(device->type);
+        }
+    }
+    call.finish(status);
+    return status;
+}
+
+Q_DECL_EXPORT SANE_Status sane_open(SANE_String_Const devicename, SANE_Handle *handle)
+{
+    static const auto real = REAL_FUNCTION(sane_open);
+    if (s_session.mode == Mode::Replay) {
+        const SANE_Status status = replayStatus(Call::Open);
+        *handle = &s_session;
+        return status;
+    }
+    if (s_session.mode == Mode::PassThrough) {
+        return real(devicename, handle);
+    }
+    CallRecord call(Call::Open);
+    const SANE_Status status = real(devicename, handle);
+    call.record.data = QByteArray(devicename);
+    call.finish(status);
+    return status;
+}
+
+Q_DECL_EXPORT void sane_close(SANE_Handle handle)
+{
+    static const auto real = REAL_FUNCTION(sane_close);
+    if (s_session.mode == Mode::Replay) {
+        replayStatus(Call::Close);
+        return;
+    }
+    if (s_session.mode == Mode::PassThrough) {
+        real(handle);
+        return;
+    }
+    CallRecord call(Call::Close);
+    real(handle);
+    call.finish(SANE_STATUS_GOOD);
+}
+
+Q_DECL_EXPORT const SANE_Option_Descriptor *sane_get_option_descriptor(SANE_Handle handle, SANE_Int option)
+{
+    static const auto real = REAL_FUNCTION(sane_get_option_descriptor);
+    if (s_session.mode == Mode::Replay) {
+        QMutexLocker locker(&s_session.mutex);
+        const int index = findQuery(Call::GetOptionDescriptor, option);
+        if (index < 0 || !s_session.descriptors.contains(index)) {
+            return nullptr;
+        }
+        waitRecorded(locker, s_session.records[index].duration);
+        return &s_session.descriptors.value(index)->descriptor;
+    }
+    if (s_session.mode == Mode::PassThrough) {
+        return real(handle, option);
+    }
+    CallRecord call(Call::GetOptionDescriptor);
+    const SANE_Option_Descriptor *descriptor = real(handle, option);
+    call.record.option = option;
+    setDescriptor(call.record, descriptor);
+    call.finish(SANE_STATUS_GOOD);
+    return descriptor;
+}
+
+Q_DECL_EXPORT SANE_Status sane_control_option(SANE_Handle handle, SANE_Int option, SANE_Action action, void *value, SANE_Int *info)
+{
+    static const auto real = REAL_FUNCTION(sane_control_option);
+    static const auto realGetOptionDescriptor = REAL_FUNCTION(sane_get_option_descriptor);
+    if (s_session.mode == Mode::Replay) {
+        return replayControlOption(option, action, value, info);
+    }
+    if (s_session.mode == Mode::PassThrough) {
+        return real(handle, option, action, value, info);
+    }
+
+    // the size of the value is known from the descriptor, strings end with their terminator
+    const SANE_Option_Descriptor *descriptor = realGetOptionDescriptor(handle, option);
+    const auto valueData = [descriptor, value]() {
+        if (descriptor == nullptr || value == nullptr) {
+            return QByteArray();
+        }
+        const char *bytes = static_cast<const char *>(value);
+        if (descriptor->type == SANE_TYPE_STRING) {
+            return QByteArray(bytes, qstrnlen(bytes, descriptor->size - 1) + 1);
+        }
+        return QByteArray(bytes, descriptor->size);
+    };
+
+    CallRecord call(Call::ControlOption);
+    call.record.option = option;
+    call.record.action = action;
+    if (action == SANE_ACTION_SET_VALUE) {
+        call.record.data = valueData();
+    }
+    SANE_Int returnedInfo = 0;
+    const SANE_Status status = real(handle, option, action, value, &returnedInfo);
+    if (info != nullptr) {
+        *info = returnedInfo;
+    }
+    call.record.info = returnedInfo;
+    call.record.dataOut = valueData();
+    call.finish(status);
+    return status;
+}
+
+Q_DECL_EXPORT SANE_Status sane_get_parameters(SANE_Handle handle, SANE_Parameters *params)
+{
+    static const auto real = REAL_FUNCTION(sane_get_parameters);
+    if (s_session.mode == Mode::Replay) {
+        QMutexLocker locker(&s_session.mutex);
+        const int index = findQuery(Call::GetParameters);
+        if (index < 0) {
+            return SANE_STATUS_INVAL;
+        }
+        waitRecorded(locker, s_session.records[index].duration);
+        *params = parameters(s_session.records[index]);
+        return SANE_Status(s_session.records[index].status);
+    }
+    if (s_session.mode == Mode::PassThrough) {
+        return real(handle, params);
+    }
+    CallRecord call(Call::GetParameters);
+    const SANE_Status status = real(handle, params);
+    setParameters(call.record, *params);
+    call.finish(status);
+    return status;
+}
+
+Q_DECL_EXPORT SANE_Status sane_start(SANE_Handle handle)
+{
+    static const auto real = REAL_FUNCTION(sane_start);
+    if (s_session.mode == Mode::Replay) {
+        QMutexLocker locker(&s_session.mutex);
+        s_session.cancelled = false;
+        s_session.pendingRead = -1;
+        const int index = findChange(Call::Start);
+        if (index < 0) {
+            return SANE_STATUS_IO_ERROR;
+        }
+        if (!waitRecordedUncancelled(s_session.records[index].duration)) {
+            return SANE_STATUS_CANCELLED;
+        }
+        return SANE_Status(s_session.records[index].status);
+    }
+    if (s_session.mode == Mode::PassThrough) {
+        return real(handle);
+    }
+    CallRecord call(Call::Start);
+    const SANE_Status status = real(handle);
+    call.finish(status);
+    return status;
+}
+
+Q_DECL_EXPORT SANE_Status sane_read(SANE_Handle handle, SANE_Byte *data, SANE_Int max_length, SANE_Int *length)
+{
+    static const auto real = REAL_FUNCTION(sane_read);
+    if (s_session.mode == Mode::Replay) {
+        return replayRead(data, max_length, length);
+    }
+    if (s_session.mode == Mode::PassThrough) {
+        return real(handle, data, max_length, length);
+    }
+    CallRecord call(Call::Read);
+    const SANE_Status status = real(handle, data, max_length, length);
+    call.record.value = max_length;
+    if (status == SANE_STATUS_GOOD) {
+        call.record.data = QByteArray(reinterpret_cast<const char *>(data), *length);
+    }
+    call.finish(status);
+    return status;
+}
+
+Q_DECL_EXPORT void sane_cancel(SANE_Handle handle)
+{
+    static const auto real = REAL_FUNCTION(sane_cancel);
+    if (s_session.mode == Mode::Replay) {
+        QMutexLocker locker(&s_session.mutex);
+        s_session.cancelled = true;
+        s_session.pendingRead = -1;
+        s_session.cancelCondition.wakeAll();
+        // a cancel which has not been recorded still stops the replayed scan
+        for (int i = s_session.position; i < s_session.records.size(); i++) {
+            if (s_session.records[i].call == Call::Cancel) {
+                s_session.position = i + 1;
+                break;
+            }
+        }
+        return;
+    }
+    if (s_session.mode == Mode::PassThrough) {
+        real(handle);
+        return;
+    }
+    CallRecord call(Call::Cancel);
+    real(handle);
+    call.finish(SANE_STATUS_GOOD);
+}
+
+Q_DECL_EXPORT SANE_Status sane_set_io_mode(SANE_Handle handle, SANE_Bool non_blocking)
+{
+    static const auto real = REAL_FUNCTION(sane_set_io_mode);
+    if (s_session.mode == Mode::Replay) {
+        return replayStatus(Call::SetIoMode);
+    }
+    if (s_session.mode == Mode::PassThrough) {
+        return real(handle, non_blocking);
+    }
+    CallRecord call(Call::SetIoMode);
+    const SANE_Status status = real(handle, non_blocking);
+    call.record.value = non_blocking;
+    call.finish(status);
+    return status;
+}
+
+Q_DECL_EXPORT SANE_Status sane_get_select_fd(SANE_Handle handle, SANE_Int *fd)
+{
+    static const auto real = REAL_FUNCTION(sane_get_select_fd);
+    if (s_session.mode == Mode::Replay) {
+        QMutexLocker locker(&s_session.mutex);
+        const int index = findQuery(Call::GetSelectFd);
+        if (index < 0 || s_session.records[index].status != SANE_STATUS_GOOD) {
+            return SANE_STATUS_UNSUPPORTED;
+        }
+        // the replayed data is always available, so the descriptor is always readable
+        if (s_session.selectPipe[0] < 0) {
+            if (pipe(s_session.selectPipe) != 0 || write(s_session.selectPipe[1], "", 1) != 1) {
+                return SANE_STATUS_IO_ERROR;
+            }
+        }
+        *fd = s_session.selectPipe[0];
+        return SANE_STATUS_GOOD;
+    }
+    if (s_session.mode == Mode::PassThrough) {
+        return real(handle, fd);
+    }
+    CallRecord call(Call::GetSelectFd);
+    const SANE_Status status = real(handle, fd);
+    call.record.value = status == SANE_STATUS_GOOD ? *fd : -1;
+    call.finish(status);
+    return status;
+}
+
+} // extern "C"
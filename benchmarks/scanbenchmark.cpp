@@ -0,0 +1,203 @@
+/*
+ * SPDX-FileCopyrightText: 2026 KSaneCore authors
+ *
+ * SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+ */
+
+/* Measures scans end to end through the public Interface API: the pages
+ * per minute, the time from starting a scan until the first rows of the
+ * image are available and the gaps between the pages of a document feeder.
+ *
+ * Built against the fake SANE implementation, the device is simulated and
+ * its timing can be configured on the command line. */
+
+#include "interface.h"
+#include "option.h"
+
+#ifdef KSANECORE_FAKE_SANE
+#include "fakesane.h"
+#endif
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QEventLoop>
+#include <QList>
+#include <QTextStream>
+
+#include <algorithm>
+
+using namespace KSaneCore;
+
+struct ScanTiming {
+    int pages = 0;
+    qint64 totalNsecs = 0;
+    qint64 firstRowNsecs = -1;
+    // from the delivery of a page until the first rows of the next page
+    QList<qint64> pageGapNsecs;
+    Interface::ScanStatus status = Interface::NoError;
+};
+
+static bool setOption(Interface &interface, Interface::OptionName name, const QVariant &value)
+{
+    Option *option = interface.getOption(name);
+    return option != nullptr && option->setValue(value);
+}
+
+/* Selects the document feeder, returns false if the device has none */
+static bool selectDocumentFeeder(Interface &interface)
+{
+    Option *source = interface.getOption(Interface::SourceOption);
+    if (source == nullptr) {
+        return false;
+    }
+    const QVariantList sources = source->internalValueList();
+    for (const QVariant &value : sources) {
+        const QString name = value.toString();
+        if (name.contains(QStringLiteral("Automatic Document Feeder")) || name.contains(QStringLiteral("ADF"))) {
+            return source->setValue(name);
+        }
+    }
+    return false;
+}
+
+static ScanTiming scan(Interface &interface)
+{
+    ScanTiming timing;
+    QElapsedTimer timer;
+    qint64 pageDelivered = -1;
+    bool pageStarted = false;
+    QEventLoop loop;
+
+    const auto rowsConnection = QObject::connect(&interface, &Interface::rowsAvailable, &loop, [&]() {
+        if (pageStarted) {
+            return;
+        }
+        pageStarted = true;
+        const qint64 now = timer.nsecsElapsed();
+        if (timing.firstRowNsecs < 0) {
+            timing.firstRowNsecs = now;
+        } else {
+            timing.pageGapNsecs.append(now - pageDelivered);
+        }
+    });
+    const auto imageConnection = QObject::connect(&interface, &Interface::scannedImageReady, &loop, [&]() {
+        timing.pages++;
+        pageDelivered = timer.nsecsElapsed();
+        pageStarted = false;
+    });
+    const auto finishedConnection = QObject::connect(&interface, &Interface::scanFinished, &loop, [&](Interface::ScanStatus status) {
+        timing.totalNsecs = timer.nsecsElapsed();
+        timing.status = status;
+        loop.quit();
+    });
+
+    timer.start();
+    interface.startScan();
+    loop.exec();
+
+    QObject::disconnect(rowsConnection);
+    QObject::disconnect(imageConnection);
+    QObject::disconnect(finishedConnection);
+    return timing;
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(QStringLiteral("Measures the throughput of scans with KSaneCore."));
+    parser.addHelpOption();
+#ifdef KSANECORE_FAKE_SANE
+    const QString defaultDevice = QStringLiteral("fake");
+#else
+    const QString defaultDevice = QStringLiteral("test");
+#endif
+    const QCommandLineOption deviceOption(QStringLiteral("device"), QStringLiteral("The SANE device to scan with."), QStringLiteral("name"), defaultDevice);
+    const QCommandLineOption modeOption(QStringLiteral("mode"), QStringLiteral("The scan mode."), QStringLiteral("mode"), QStringLiteral("Color"));
+    const QCommandLineOption depthOption(QStringLiteral("depth"), QStringLiteral("The bit depth."), QStringLiteral("bits"), QStringLiteral("8"));
+    const QCommandLineOption resolutionOption(QStringLiteral("resolution"), QStringLiteral("The scan resolution."), QStringLiteral("dpi"), QStringLiteral("300"));
+    const QCommandLineOption pagesOption(QStringLiteral("pages"),
+                                         QStringLiteral("Scan this many pages from the document feeder, 1 scans the flatbed."),
+                                         QStringLiteral("count"),
+                                         QStringLiteral("1"));
+    const QCommandLineOption repeatOption(QStringLiteral("repeat"), QStringLiteral("Number of measured scans."), QStringLiteral("count"), QStringLiteral("3"));
+    parser.addOptions({deviceOption, modeOption, depthOption, resolutionOption, pagesOption, repeatOption});
+#ifdef KSANECORE_FAKE_SANE
+    const QCommandLineOption threePassOption(QStringLiteral("three-pass"), QStringLiteral("Send color scans as one frame per channel."));
+    const QCommandLineOption linesOption(QStringLiteral("lines"),
+                                         QStringLiteral("Lines of a page, 0 follows the scan area, -1 behaves like a hand scanner."),
+                                         QStringLiteral("lines"),
+                                         QStringLiteral("0"));
+    const QCommandLineOption readSizeOption(QStringLiteral("read-size"), QStringLiteral("Maximum bytes returned by sane_read()."), QStringLiteral("bytes"), QStringLiteral("32768"));
+    const QCommandLineOption readLatencyOption(QStringLiteral("read-latency"), QStringLiteral("Duration of a sane_read() call."), QStringLiteral("us"), QStringLiteral("0"));
+    const QCommandLineOption startLatencyOption(QStringLiteral("start-latency"), QStringLiteral("Duration of sane_start() for a page."), QStringLiteral("ms"), QStringLiteral("0"));
+    parser.addOptions({threePassOption, linesOption, readSizeOption, readLatencyOption, startLatencyOption});
+#endif
+    parser.process(app);
+
+    const int pages = qMax(parser.value(pagesOption).toInt(), 1);
+    const int repeat = qMax(parser.value(repeatOption).toInt(), 1);
+
+#ifdef KSANECORE_FAKE_SANE
+    FakeSane::Config config;
+    config.threePass = parser.isSet(threePassOption);
+    config.lines = parser.value(linesOption).toInt();
+    config.readSize = parser.value(readSizeOption).toInt();
+    config.readLatency = parser.value(readLatencyOption).toInt();
+    config.startLatency = parser.value(startLatencyOption).toInt();
+    config.feederPages = pages;
+    FakeSane::setConfig(config);
+#endif
+
+    QTextStream out(stdout);
+    QTextStream err(stderr);
+
+    Interface interface;
+    if (interface.openDevice(parser.value(deviceOption)) != Interface::OpeningSucceeded) {
+        err << "Failed to open the device " << parser.value(deviceOption) << "\n";
+        return 1;
+    }
+    if (!setOption(interface, Interface::ScanModeOption, parser.value(modeOption))) {
+        err << "Failed to set the scan mode " << parser.value(modeOption) << "\n";
+    }
+    if (!setOption(interface, Interface::BitDepthOption, parser.value(depthOption).toInt())) {
+        err << "Failed to set the bit depth " << parser.value(depthOption) << "\n";
+    }
+    if (!setOption(interface, Interface::ResolutionOption, parser.value(resolutionOption).toInt())) {
+        err << "Failed to set the resolution " << parser.value(resolutionOption) << "\n";
+    }
+    if (pages > 1 && !selectDocumentFeeder(interface)) {
+        err << "The device has no document feeder\n";
+        return 1;
+    }
+
+    // the first scan sets up the buffers and is not measured
+    scan(interface);
+
+    for (int run = 1; run <= repeat; run++) {
+        const ScanTiming timing = scan(interface);
+        const double seconds = timing.totalNsecs / 1e9;
+        out << "run " << run << ": " << timing.pages << " pages in " << QString::number(seconds, 'f', 3) << " s, "
+            << QString::number(timing.pages * 60 / seconds, 'f', 1) << " pages/min, first rows after "
+            << QString::number(timing.firstRowNsecs / 1e6, 'f', 1) << " ms";
+        if (!timing.pageGapNsecs.isEmpty()) {
+            qint64 sum = 0;
+            for (qint64 gap : timing.pageGapNsecs) {
+                sum += gap;
+            }
+            const qint64 maximum = *std::max_element(timing.pageGapNsecs.constBegin(), timing.pageGapNsecs.constEnd());
+            out << ", page gap " << QString::number(sum / timing.pageGapNsecs.size() / 1e6, 'f', 1) << " ms average, "
+                << QString::number(maximum / 1e6, 'f', 1) << " ms maximum";
+        }
+        if (timing.status == Interface::ErrorGeneral) {
+            out << ", failed";
+        }
+        out << "\n";
+        out.flush();
+    }
+
+    interface.closeDevice();
+    return 0;
+}
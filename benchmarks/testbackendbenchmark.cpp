@@ -0,0 +1,269 @@
+/*
+ * SPDX-FileCopyrightText: 2026 KSaneCore authors
+ *
+ * SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+ */
+
+/* Scans with the SANE test backend, which needs no hardware, with a sweep
+ * over its frame formats, bit depths, three-pass and hand scanner modes,
+ * read limits, read delays and non-blocking reads. The results are printed
+ * as JSON: the time to open the device and load its options, the time to
+ * set the options, the time until the first rows, the throughput of the
+ * scan and the memory high-water mark of the process. The throughput of the
+ * scan is measured with the wall time from starting the scan until it has
+ * finished, next to it the time spent in sane_read() and decoding the data
+ * is taken from the statistics of the scanned pages.
+ *
+ * Usage: testbackendbenchmark [--device test:0] [--resolution dpi] [--repeat n] [filter] */
+
+#include "interface.h"
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QEventLoop>
+#include <QFile>
+#include <QImage>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QList>
+#include <QMap>
+#include <QTextStream>
+
+#include <algorithm>
+#include <utility>
+
+using namespace KSaneCore;
+
+struct BenchmarkCase {
+    const char *name;
+    QMap<QString, QString> options;
+};
+
+struct ScanTiming {
+    double firstRowMs = -1;
+    double scanMs = 0;
+    qint64 bytes = 0;
+    // sums of the statistics of the scanned pages
+    qint64 readNsecs = 0;
+    qint64 decodeNsecs = 0;
+    bool succeeded = false;
+};
+
+/* Returns the peak resident memory of the process in KiB, 0 if it is unknown */
+static qint64 peakMemory()
+{
+    QFile status(QStringLiteral("/proc/self/status"));
+    if (!status.open(QIODevice::ReadOnly)) {
+        return 0;
+    }
+    const QList<QByteArray> lines = status.readAll().split('\n');
+    for (const QByteArray &line : lines) {
+        if (line.startsWith("VmHWM:")) {
+            return line.mid(6).trimmed().split(' ').constFirst().toLongLong();
+        }
+    }
+    return 0;
+}
+
+/* Lets the peak resident memory start again from the current one, if the kernel supports it */
+static void resetPeakMemory()
+{
+    QFile clearRefs(QStringLiteral("/proc/self/clear_refs"));
+    if (clearRefs.open(QIODevice::WriteOnly)) {
+        clearRefs.write("5");
+    }
+}
+
+/* The number of bytes of an image as sent by the scanner */
+static qint64 scannedBytes(const QImage &image, const QMap<QString, QString> &options)
+{
+    const int depth = options.value(QStringLiteral("depth")).toInt();
+    const int samples = options.value(QStringLiteral("mode")) == QLatin1String("Color") ? 3 : 1;
+    const qint64 bytesPerLine = depth == 1 ? (image.width() + 7) / 8 : qint64(image.width()) * samples * depth / 8;
+    return bytesPerLine * image.height();
+}
+
+static ScanTiming scan(Interface &interface, const QMap<QString, QString> &options)
+{
+    ScanTiming timing;
+    QElapsedTimer timer;
+    QEventLoop loop;
+
+    QObject::connect(&interface, &Interface::rowsAvailable, &loop, [&]() {
+        if (timing.firstRowMs < 0) {
+            timing.firstRowMs = timer.nsecsElapsed() / 1e6;
+        }
+    });
+    QObject::connect(&interface, &Interface::scanStatisticsReady, &loop, [&](const ScanStatistics &statistics) {
+        timing.readNsecs += statistics.readNsecs;
+        timing.decodeNsecs += statistics.decodeNsecs;
+    });
+    QObject::connect(&interface, &Interface::scannedImageReady, &loop, [&](const QImage &image) {
+        timing.bytes += scannedBytes(image, options);
+    });
+    QObject::connect(&interface, &Interface::scanFinished, &loop, [&](Interface::ScanStatus status) {
+        timing.scanMs = timer.nsecsElapsed() / 1e6;
+        timing.succeeded = status == Interface::NoError && timing.bytes > 0;
+        loop.quit();
+    });
+
+    timer.start();
+    interface.startScan();
+    loop.exec();
+    return timing;
+}
+
+static double median(QList<double> values)
+{
+    if (values.isEmpty()) {
+        return 0;
+    }
+    std::sort(values.begin(), values.end());
+    return values.at(values.size() / 2);
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(QStringLiteral("Measures KSaneCore with the SANE test backend."));
+    parser.addHelpOption();
+    const QCommandLineOption deviceOption(QStringLiteral("device"), QStringLiteral("The test device."), QStringLiteral("name"), QStringLiteral("test:0"));
+    const QCommandLineOption resolutionOption(QStringLiteral("resolution"), QStringLiteral("The scan resolution."), QStringLiteral("dpi"), QStringLiteral("300"));
+    const QCommandLineOption repeatOption(QStringLiteral("repeat"), QStringLiteral("Number of measured scans per case."), QStringLiteral("count"), QStringLiteral("3"));
+    const QCommandLineOption outputOption(QStringLiteral("output"), QStringLiteral("Write the results to this file."), QStringLiteral("file"));
+    parser.addOptions({deviceOption, resolutionOption, repeatOption, outputOption});
+    parser.addPositionalArgument(QStringLiteral("filter"), QStringLiteral("Only run the cases whose name contains the filter."));
+    parser.process(app);
+
+    const QString deviceName = parser.value(deviceOption);
+    const QString resolution = parser.value(resolutionOption);
+    const int repeat = qMax(parser.value(repeatOption).toInt(), 1);
+    const QString filter = parser.positionalArguments().value(0);
+
+    const auto options = [&resolution](std::initializer_list<std::pair<const char *, const char *>> values) {
+        QMap<QString, QString> map = {
+            {QStringLiteral("resolution"), resolution},
+            {QStringLiteral("hand-scanner"), QStringLiteral("false")},
+            {QStringLiteral("read-limit"), QStringLiteral("false")},
+            {QStringLiteral("read-delay"), QStringLiteral("false")},
+            {QStringLiteral("non-blocking"), QStringLiteral("false")},
+            {QStringLiteral("select-fd"), QStringLiteral("false")},
+        };
+        for (const auto &value : values) {
+            map.insert(QString::fromLatin1(value.first), QString::fromLatin1(value.second));
+        }
+        // the backend keeps its options while it is initialized, three-pass is only available for color scans
+        if (map.value(QStringLiteral("mode")) == QLatin1String("Color") && !map.contains(QStringLiteral("three-pass"))) {
+            map.insert(QStringLiteral("three-pass"), QStringLiteral("false"));
+        }
+        return map;
+    };
+
+    const QList<BenchmarkCase> cases = {
+        {"gray1", options({{"mode", "Gray"}, {"depth", "1"}})},
+        {"gray8", options({{"mode", "Gray"}, {"depth", "8"}})},
+        {"gray16", options({{"mode", "Gray"}, {"depth", "16"}})},
+        {"color8", options({{"mode", "Color"}, {"depth", "8"}})},
+        {"color16", options({{"mode", "Color"}, {"depth", "16"}})},
+        {"threepass8", options({{"mode", "Color"}, {"depth", "8"}, {"three-pass", "true"}})},
+        {"threepass16", options({{"mode", "Color"}, {"depth", "16"}, {"three-pass", "true"}})},
+        {"handscanner8", options({{"mode", "Gray"}, {"depth", "8"}, {"hand-scanner", "true"}})},
+        {"readlimit4k", options({{"mode", "Color"}, {"depth", "8"}, {"read-limit", "true"}, {"read-limit-size", "4096"}})},
+        {"readdelay", options({{"mode", "Color"}, {"depth", "8"}, {"read-limit", "true"}, {"read-limit-size", "32768"}, {"read-delay", "true"}, {"read-delay-duration", "1000"}})},
+        {"nonblocking8", options({{"mode", "Color"}, {"depth", "8"}, {"non-blocking", "true"}, {"select-fd", "true"}})},
+    };
+
+    QTextStream err(stderr);
+    QJsonArray results;
+    Interface interface;
+
+    for (const BenchmarkCase &benchmarkCase : cases) {
+        const QString name = QString::fromLatin1(benchmarkCase.name);
+        if (!filter.isEmpty() && !name.contains(filter)) {
+            continue;
+        }
+        QJsonObject result;
+        result.insert(QStringLiteral("name"), name);
+
+        resetPeakMemory();
+        QElapsedTimer timer;
+        timer.start();
+        if (interface.openDevice(deviceName) != Interface::OpeningSucceeded) {
+            err << "Failed to open the device " << deviceName << "\n";
+            return 1;
+        }
+        result.insert(QStringLiteral("optionLoadMs"), timer.nsecsElapsed() / 1e6);
+
+        timer.restart();
+        const int optionsSet = interface.setOptionsMap(benchmarkCase.options);
+        result.insert(QStringLiteral("optionSetMs"), timer.nsecsElapsed() / 1e6);
+        if (optionsSet != benchmarkCase.options.size()) {
+            err << name << ": " << optionsSet << " of " << benchmarkCase.options.size() << " options could be set\n";
+        }
+        QJsonObject optionValues;
+        for (auto it = benchmarkCase.options.cbegin(); it != benchmarkCase.options.cend(); ++it) {
+            optionValues.insert(it.key(), it.value());
+        }
+        result.insert(QStringLiteral("options"), optionValues);
+
+        // the first scan sets up the buffers and is not measured
+        ScanTiming timing = scan(interface, benchmarkCase.options);
+        bool succeeded = timing.succeeded;
+        QList<double> firstRowMs;
+        QList<double> scanMs;
+        QList<double> readMs;
+        QList<double> decodeMs;
+        qint64 bytes = timing.bytes;
+        for (int run = 0; run < repeat && succeeded; run++) {
+            timing = scan(interface, benchmarkCase.options);
+            succeeded = timing.succeeded;
+            firstRowMs.append(timing.firstRowMs);
+            scanMs.append(timing.scanMs);
+            readMs.append(timing.readNsecs / 1e6);
+            decodeMs.append(timing.decodeNsecs / 1e6);
+            bytes = timing.bytes;
+        }
+
+        result.insert(QStringLiteral("succeeded"), succeeded);
+        if (succeeded) {
+            const double scanTime = median(scanMs);
+            const double readTime = median(readMs);
+            const double decodeTime = median(decodeMs);
+            result.insert(QStringLiteral("bytes"), bytes);
+            result.insert(QStringLiteral("firstRowMs"), median(firstRowMs));
+            result.insert(QStringLiteral("scanMs"), scanTime);
+            result.insert(QStringLiteral("scanThroughputMBps"), bytes / scanTime / 1e3);
+            result.insert(QStringLiteral("readMs"), readTime);
+            result.insert(QStringLiteral("decodeMs"), decodeTime);
+            if (decodeTime > 0) {
+                result.insert(QStringLiteral("decodeThroughputMBps"), bytes / decodeTime / 1e3);
+            }
+        }
+        result.insert(QStringLiteral("peakMemoryKiB"), peakMemory());
+        results.append(result);
+
+        interface.closeDevice();
+    }
+
+    QJsonObject report;
+    report.insert(QStringLiteral("device"), deviceName);
+    report.insert(QStringLiteral("resolution"), resolution.toInt());
+    report.insert(QStringLiteral("repeat"), repeat);
+    report.insert(QStringLiteral("cases"), results);
+    const QByteArray json = QJsonDocument(report).toJson();
+
+    if (parser.isSet(outputOption)) {
+        QFile output(parser.value(outputOption));
+        if (!output.open(QIODevice::WriteOnly | QIODevice::Truncate) || output.write(json) != json.size()) {
+            err << "Failed to write " << output.fileName() << "\n";
+            return 1;
+        }
+    } else {
+        QTextStream(stdout) << json;
+    }
+    return 0;
+}
@@ -0,0 +1,450 @@
+/*
+ * SPDX-FileCopyrightText: 2026 KSaneCore authors
+ *
+ * SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+ */
+
+#include "fakesane.h"
+
+extern "C"
+{
+#include <sane/saneopts.h>
+}
+
+#include <QByteArray>
+#include <QDeadlineTimer>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QRandomGenerator>
+#include <QWaitCondition>
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+namespace FakeSane
+{
+
+static Config s_config;
+
+void setConfig(const Config &config)
+{
+    s_config = config;
+}
+
+Config config()
+{
+    return s_config;
+}
+
+} // namespace FakeSane
+
+using FakeSane::s_config;
+
+namespace
+{
+
+enum OptionIndex {
+    NumOptions,
+    ModeOption,
+    DepthOption,
+    ResolutionOption,
+    SourceOption,
+    TopLeftXOption,
+    TopLeftYOption,
+    BottomRightXOption,
+    BottomRightYOption,
+    PreviewOption,
+    OptionCount
+};
+
+const SANE_String_Const modeList[] = {SANE_VALUE_SCAN_MODE_COLOR, SANE_VALUE_SCAN_MODE_GRAY, SANE_VALUE_SCAN_MODE_LINEART, nullptr};
+const SANE_String_Const sourceList[] = {"Flatbed", "Automatic Document Feeder", nullptr};
+const SANE_Word depthList[] = {2, 8, 16};
+const SANE_Range resolutionRange = {75, 1200, 1};
+const SANE_Range xRange = {0, SANE_FIX(215.9), 0};
+const SANE_Range yRange = {0, SANE_FIX(297.0), 0};
+
+// the synthetic data of all frames is taken from this block
+constexpr int NoiseSize = 1024 * 1024;
+
+struct Device {
+    SANE_Option_Descriptor descriptors[OptionCount];
+    SANE_Word words[OptionCount];
+    QByteArray strings[OptionCount];
+    QByteArray noise;
+    bool open = false;
+
+    // state of the scan, sane_cancel() is called from another thread than the other functions
+    QMutex mutex;
+    QWaitCondition cancelCondition;
+    bool cancelled = false;
+    bool scanning = false;
+    bool pageActive = false;
+    int frame = 0;
+    int fedPages = 0;
+    int startedPages = 0;
+    SANE_Parameters params;
+    qint64 frameSize = 0;
+    qint64 frameRead = 0;
+};
+
+Device s_device;
+
+const SANE_Device s_deviceInfo = {"fake", "KSaneCore", "Fake scanner", "virtual device"};
+const SANE_Device *s_deviceList[] = {&s_deviceInfo, nullptr};
+
+void setDescriptor(OptionIndex index, SANE_String_Const name, SANE_String_Const title, SANE_Value_Type type, SANE_Unit unit, SANE_Int size)
+{
+    SANE_Option_Descriptor &descriptor = s_device.descriptors[index];
+    descriptor = SANE_Option_Descriptor();
+    descriptor.name = name;
+    descriptor.title = title;
+    descriptor.desc = title;
+    descriptor.type = type;
+    descriptor.unit = unit;
+    descriptor.size = size;
+    descriptor.cap = SANE_CAP_SOFT_SELECT | SANE_CAP_SOFT_DETECT;
+    descriptor.constraint_type = SANE_CONSTRAINT_NONE;
+}
+
+void setRange(OptionIndex index, const SANE_Range *range, SANE_Word value)
+{
+    s_device.descriptors[index].constraint_type = SANE_CONSTRAINT_RANGE;
+    s_device.descriptors[index].constraint.range = range;
+    s_device.words[index] = value;
+}
+
+void initDevice()
+{
+    setDescriptor(NumOptions, "", SANE_TITLE_NUM_OPTIONS, SANE_TYPE_INT, SANE_UNIT_NONE, sizeof(SANE_Word));
+    s_device.descriptors[NumOptions].cap = SANE_CAP_SOFT_DETECT;
+    s_device.words[NumOptions] = OptionCount;
+
+    setDescriptor(ModeOption, SANE_NAME_SCAN_MODE, SANE_TITLE_SCAN_MODE, SANE_TYPE_STRING, SANE_UNIT_NONE, 32);
+    s_device.descriptors[ModeOption].constraint_type = SANE_CONSTRAINT_STRING_LIST;
+    s_device.descriptors[ModeOption].constraint.string_list = modeList;
+    s_device.strings[ModeOption] = SANE_VALUE_SCAN_MODE_COLOR;
+
+    setDescriptor(DepthOption, SANE_NAME_BIT_DEPTH, SANE_TITLE_BIT_DEPTH, SANE_TYPE_INT, SANE_UNIT_BIT, sizeof(SANE_Word));
+    s_device.descriptors[DepthOption].constraint_type = SANE_CONSTRAINT_WORD_LIST;
+    s_device.descriptors[DepthOption].constraint.word_list = depthList;
+    s_device.words[DepthOption] = 8;
+
+    setDescriptor(ResolutionOption, SANE_NAME_SCAN_RESOLUTION, SANE_TITLE_SCAN_RESOLUTION, SANE_TYPE_INT, SANE_UNIT_DPI, sizeof(SANE_Word));
+    setRange(ResolutionOption, &resolutionRange, 300);
+
+    setDescriptor(SourceOption, SANE_NAME_SCAN_SOURCE, SANE_TITLE_SCAN_SOURCE, SANE_TYPE_STRING, SANE_UNIT_NONE, 32);
+    s_device.descriptors[SourceOption].constraint_type = SANE_CONSTRAINT_STRING_LIST;
+    s_device.descriptors[SourceOption].constraint.string_list = sourceList;
+    s_device.strings[SourceOption] = sourceList[0];
+
+    setDescriptor(TopLeftXOption, SANE_NAME_SCAN_TL_X, SANE_TITLE_SCAN_TL_X, SANE_TYPE_FIXED, SANE_UNIT_MM, sizeof(SANE_Word));
+    setRange(TopLeftXOption, &xRange, xRange.min);
+    setDescriptor(TopLeftYOption, SANE_NAME_SCAN_TL_Y, SANE_TITLE_SCAN_TL_Y, SANE_TYPE_FIXED, SANE_UNIT_MM, sizeof(SANE_Word));
+    setRange(TopLeftYOption, &yRange, yRange.min);
+    setDescriptor(BottomRightXOption, SANE_NAME_SCAN_BR_X, SANE_TITLE_SCAN_BR_X, SANE_TYPE_FIXED, SANE_UNIT_MM, sizeof(SANE_Word));
+    setRange(BottomRightXOption, &xRange, xRange.max);
+    setDescriptor(BottomRightYOption, SANE_NAME_SCAN_BR_Y, SANE_TITLE_SCAN_BR_Y, SANE_TYPE_FIXED, SANE_UNIT_MM, sizeof(SANE_Word));
+    setRange(BottomRightYOption, &yRange, yRange.max);
+
+    setDescriptor(PreviewOption, SANE_NAME_PREVIEW, SANE_TITLE_PREVIEW, SANE_TYPE_BOOL, SANE_UNIT_NONE, sizeof(SANE_Word));
+    s_device.words[PreviewOption] = SANE_FALSE;
+
+    if (s_device.noise.isEmpty()) {
+        s_device.noise = QByteArray(NoiseSize, Qt::Uninitialized);
+        QRandomGenerator random(1);
+        random.fillRange(reinterpret_cast<quint32 *>(s_device.noise.data()), NoiseSize / sizeof(quint32));
+    }
+}
+
+/* The lines of a frame in the scan area, also for hand scanner frames which do not announce them */
+int areaLines()
+{
+    if (s_config.lines > 0) {
+        return s_config.lines;
+    }
+    const double height = SANE_UNFIX(s_device.words[BottomRightYOption] - s_device.words[TopLeftYOption]);
+    return qMax(1, int(height / 25.4 * s_device.words[ResolutionOption]));
+}
+
+SANE_Parameters frameParameters(int frame)
+{
+    const QByteArray &mode = s_device.strings[ModeOption];
+    const bool color = mode == SANE_VALUE_SCAN_MODE_COLOR;
+    const double width = SANE_UNFIX(s_device.words[BottomRightXOption] - s_device.words[TopLeftXOption]);
+
+    SANE_Parameters params;
+    params.depth = mode == SANE_VALUE_SCAN_MODE_LINEART ? 1 : s_device.words[DepthOption];
+    params.pixels_per_line = qMax(1, int(width / 25.4 * s_device.words[ResolutionOption]));
+    params.lines = s_config.lines < 0 ? -1 : areaLines();
+    if (color && s_config.threePass) {
+        params.format = SANE_Frame(SANE_FRAME_RED + frame);
+        params.last_frame = frame == 2 ? SANE_TRUE : SANE_FALSE;
+    } else {
+        params.format = color ? SANE_FRAME_RGB : SANE_FRAME_GRAY;
+        params.last_frame = SANE_TRUE;
+    }
+    const int samples = params.format == SANE_FRAME_RGB ? 3 : 1;
+    params.bytes_per_line = params.depth == 1 ? (params.pixels_per_line + 7) / 8 : params.pixels_per_line * samples * (params.depth / 8);
+    return params;
+}
+
+/* Waits for the given time unless the scan is cancelled, returns false if it has been cancelled.
+ * Called with the mutex of the device locked. */
+bool waitUncancelled(std::chrono::microseconds duration)
+{
+    const QDeadlineTimer deadline(duration);
+    while (!s_device.cancelled && !deadline.hasExpired()) {
+        s_device.cancelCondition.wait(&s_device.mutex, deadline);
+    }
+    return !s_device.cancelled;
+}
+
+} // namespace
+
+int FakeSane::startedPages()
+{
+    QMutexLocker locker(&s_device.mutex);
+    return s_device.startedPages;
+}
+
+extern "C" {
+
+SANE_Status sane_init(SANE_Int *version_code, SANE_Auth_Callback authorize)
+{
+    Q_UNUSED(authorize)
+    if (version_code != nullptr) {
+        *version_code = SANE_VERSION_CODE(SANE_CURRENT_MAJOR, 0, 0);
+    }
+    return SANE_STATUS_GOOD;
+}
+
+void sane_exit(void)
+{
+}
+
+SANE_Status sane_get_devices(const SANE_Device ***device_list, SANE_Bool local_only)
+{
+    Q_UNUSED(local_only)
+    *device_list = s_deviceList;
+    return SANE_STATUS_GOOD;
+}
+
+SANE_Status sane_open(SANE_String_Const devicename, SANE_Handle *handle)
+{
+    if (devicename[0] != '\0' && strcmp(devicename, s_deviceInfo.name) != 0) {
+        return SANE_STATUS_INVAL;
+    }
+    if (s_device.open) {
+        return SANE_STATUS_DEVICE_BUSY;
+    }
+    initDevice();
+    s_device.startedPages = 0;
+    s_device.open = true;
+    *handle = &s_device;
+    return SANE_STATUS_GOOD;
+}
+
+void sane_close(SANE_Handle handle)
+{
+    Q_UNUSED(handle)
+    sane_cancel(handle);
+    s_device.open = false;
+}
+
+const SANE_Option_Descriptor *sane_get_option_descriptor(SANE_Handle handle, SANE_Int option)
+{
+    Q_UNUSED(handle)
+    if (option < 0 || option >= OptionCount) {
+        return nullptr;
+    }
+    return &s_device.descriptors[option];
+}
+
+SANE_Status sane_control_option(SANE_Handle handle, SANE_Int option, SANE_Action action, void *value, SANE_Int *info)
+{
+    Q_UNUSED(handle)
+    if (info != nullptr) {
+        *info = 0;
+    }
+    if (option < 0 || option >= OptionCount || value == nullptr) {
+        return SANE_STATUS_INVAL;
+    }
+    const SANE_Option_Descriptor &descriptor = s_device.descriptors[option];
+
+    if (action == SANE_ACTION_GET_VALUE) {
+        if (descriptor.type == SANE_TYPE_STRING) {
+            qstrncpy(static_cast<char *>(value), s_device.strings[option].constData(), descriptor.size);
+        } else {
+            *static_cast<SANE_Word *>(value) = s_device.words[option];
+        }
+        return SANE_STATUS_GOOD;
+    }
+    if (action != SANE_ACTION_SET_VALUE || option == NumOptions) {
+        return SANE_STATUS_INVAL;
+    }
+
+    QMutexLocker locker(&s_device.mutex);
+    if (s_device.pageActive) {
+        return SANE_STATUS_DEVICE_BUSY;
+    }
+    if (descriptor.type == SANE_TYPE_STRING) {
+        const QByteArray string(static_cast<const char *>(value));
+        bool valid = false;
+        for (int i = 0; descriptor.constraint.string_list[i] != nullptr; i++) {
+            valid = valid || string == descriptor.constraint.string_list[i];
+        }
+        if (!valid) {
+            return SANE_STATUS_INVAL;
+        }
+        s_device.strings[option] = string;
+    } else {
+        SANE_Word word = *static_cast<const SANE_Word *>(value);
+        if (descriptor.constraint_type == SANE_CONSTRAINT_RANGE) {
+            const SANE_Word bounded = qBound(descriptor.constraint.range->min, word, descriptor.constraint.range->max);
+            if (bounded != word && info != nullptr) {
+                *info |= SANE_INFO_INEXACT;
+            }
+            word = bounded;
+        } else if (descriptor.constraint_type == SANE_CONSTRAINT_WORD_LIST) {
+            bool valid = false;
+            for (int i = 1; i <= descriptor.constraint.word_list[0]; i++) {
+                valid = valid || word == descriptor.constraint.word_list[i];
+            }
+            if (!valid) {
+                return SANE_STATUS_INVAL;
+            }
+        }
+        s_device.words[option] = word;
+    }
+    if (info != nullptr) {
+        *info |= SANE_INFO_RELOAD_PARAMS;
+    }
+    return SANE_STATUS_GOOD;
+}
+
+SANE_Status sane_get_parameters(SANE_Handle handle, SANE_Parameters *params)
+{
+    Q_UNUSED(handle)
+    QMutexLocker locker(&s_device.mutex);
+    *params = s_device.pageActive ? s_device.params : frameParameters(0);
+    return SANE_STATUS_GOOD;
+}
+
+SANE_Status sane_start(SANE_Handle handle)
+{
+    Q_UNUSED(handle)
+    QMutexLocker locker(&s_device.mutex);
+    s_device.cancelled = false;
+    if (s_device.pageActive) {
+        // the next color channel of a three-pass scan
+        s_device.frame++;
+    } else {
+        if (s_device.strings[SourceOption] == sourceList[1]) {
+            if (s_device.fedPages >= s_config.feederPages) {
+                s_device.fedPages = 0;
+                return SANE_STATUS_NO_DOCS;
+            }
+            s_device.fedPages++;
+        }
+        if (!waitUncancelled(std::chrono::milliseconds(s_config.startLatency))) {
+            return SANE_STATUS_CANCELLED;
+        }
+        s_device.frame = 0;
+        s_device.pageActive = true;
+        s_device.startedPages++;
+    }
+    s_device.params = frameParameters(s_device.frame);
+    s_device.frameSize = qint64(s_device.params.bytes_per_line) * areaLines();
+    s_device.frameRead = 0;
+    s_device.scanning = true;
+    return SANE_STATUS_GOOD;
+}
+
+SANE_Status sane_read(SANE_Handle handle, SANE_Byte *data, SANE_Int max_length, SANE_Int *length)
+{
+    Q_UNUSED(handle)
+    *length = 0;
+    QMutexLocker locker(&s_device.mutex);
+    if (s_device.cancelled) {
+        s_device.scanning = false;
+        s_device.pageActive = false;
+        return SANE_STATUS_CANCELLED;
+    }
+    if (!s_device.scanning) {
+        return SANE_STATUS_INVAL;
+    }
+    if (s_device.frameRead >= s_device.frameSize) {
+        s_device.scanning = false;
+        s_device.pageActive = s_device.params.last_frame == SANE_FALSE;
+        return SANE_STATUS_EOF;
+    }
+    if (!waitUncancelled(std::chrono::microseconds(s_config.readLatency))) {
+        return SANE_STATUS_CANCELLED;
+    }
+
+    const int offset = int(s_device.frameRead % NoiseSize);
+    const int bytes = int(std::min({qint64(max_length), qint64(qMax(s_config.readSize, 1)), s_device.frameSize - s_device.frameRead, qint64(NoiseSize - offset)}));
+    memcpy(data, s_device.noise.constData() + offset, bytes);
+    s_device.frameRead += bytes;
+    *length = bytes;
+    return SANE_STATUS_GOOD;
+}
+
+void sane_cancel(SANE_Handle handle)
+{
+    Q_UNUSED(handle)
+    QMutexLocker locker(&s_device.mutex);
+    s_device.cancelled = true;
+    s_device.scanning = false;
+    s_device.pageActive = false;
+    s_device.cancelCondition.wakeAll();
+}
+
+SANE_Status sane_set_io_mode(SANE_Handle handle, SANE_Bool non_blocking)
+{
+    Q_UNUSED(handle)
+    // the fake device is only read with blocking calls
+    return non_blocking ? SANE_STATUS_UNSUPPORTED : SANE_STATUS_GOOD;
+}
+
+SANE_Status sane_get_select_fd(SANE_Handle handle, SANE_Int *fd)
+{
+    Q_UNUSED(handle)
+    Q_UNUSED(fd)
+    return SANE_STATUS_UNSUPPORTED;
+}
+
+SANE_String_Const sane_strstatus(SANE_Status status)
+{
+    switch (status) {
+    case SANE_STATUS_GOOD:
+        return "Success";
+    case SANE_STATUS_UNSUPPORTED:
+        return "Operation not supported";
+    case SANE_STATUS_CANCELLED:
+        return "Operation was cancelled";
+    case SANE_STATUS_DEVICE_BUSY:
+        return "Device busy";
+    case SANE_STATUS_INVAL:
+        return "Invalid argument";
+    case SANE_STATUS_EOF:
+        return "End of file reached";
+    case SANE_STATUS_JAMMED:
+        return "Document feeder jammed";
+    case SANE_STATUS_NO_DOCS:
+        return "Document feeder out of documents";
+    case SANE_STATUS_COVER_OPEN:
+        return "Scanner cover is open";
+    case SANE_STATUS_IO_ERROR:
+        return "Error during device I/O";
+    case SANE_STATUS_NO_MEM:
+        return "Out of memory";
+    case SANE_STATUS_ACCESS_DENIED:
+        return "Access to resource has been denied";
+    }
+    return "Unknown SANE status code";
+}
+
+} // extern "C"
@@ -0,0 +1,47 @@
+/*
+ * SPDX-FileCopyrightText: 2026 KSaneCore authors
+ *
+ * SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+ */
+
+#ifndef KSANE_FAKE_SANE_H
+#define KSANE_FAKE_SANE_H
+
+extern "C"
+{
+#include <sane/sane.h>
+}
+
+/* A SANE implementation without hardware, linked instead of libsane to
+ * measure KSaneCore end to end. It provides the single device "fake" with
+ * the usual scan mode, bit depth, resolution, source and scan area options.
+ * The scanned data is synthetic, the geometry of the frames follows the
+ * options unless it is overridden by the configuration. */
+namespace FakeSane
+{
+
+struct Config {
+    // deliver color scans as three frames, one per color channel
+    bool threePass = false;
+    // number of lines of a frame, 0 follows the scan area, -1 behaves like a hand scanner
+    int lines = 0;
+    // maximum number of bytes returned by one sane_read() call
+    int readSize = 32 * 1024;
+    // time each sane_read() call takes, in microseconds
+    int readLatency = 0;
+    // time sane_start() takes to feed a page, in milliseconds
+    int startLatency = 0;
+    // number of pages in the document feeder, the feeder is filled again once it has run empty
+    int feederPages = 10;
+};
+
+/* Only called while no device is scanning */
+void setConfig(const Config &config);
+Config config();
+
+/* Number of pages which have been started since the device has been opened */
+int startedPages();
+
+} // namespace FakeSane
+
+#endif // KSANE_FAKE_SANE_H
@@ -0,0 +1,214 @@
+/*
+ * SPDX-FileCopyrightText: 2026 KSaneCore authors
+ *
+ * SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+ */
+
+#include "imagebufferpool.h"
+
+#include <QDir>
+#include <QMutexLocker>
+#include <QStandardPaths>
+
+#include <ksanecore_debug.h>
+
+#include <cstdlib>
+
+namespace KSaneCore
+{
+
+ImageBufferPool::ImageBufferPool(int maxIdleBuffers)
+    : m_maxIdleBuffers(maxIdleBuffers)
+{
+}
+
+ImageBufferPool::~ImageBufferPool()
+{
+    for (const IdleBuffer &idleBuffer : std::as_const(m_idleBuffers)) {
+        free(idleBuffer.data);
+    }
+}
+
+void ImageBufferPool::setMappingThreshold(qsizetype size)
+{
+    QMutexLocker locker(&m_mutex);
+    m_mappingThreshold = size;
+}
+
+bool ImageBufferPool::isMapped(qsizetype size)
+{
+    QMutexLocker locker(&m_mutex);
+    return m_mappingThreshold > 0 && size > m_mappingThreshold;
+}
+
+static QString mappingDirectory()
+{
+    // the temporary directory is kept in memory on many systems, which would not relieve the memory
+    const QString cacheDirectory = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+    if (!cacheDirectory.isEmpty() && QDir().mkpath(cacheDirectory)) {
+        return cacheDirectory;
+    }
+    return QDir::tempPath();
+}
+
+bool ImageBufferPool::mapFile(ImageBuffer *buffer, qsizetype size)
+{
+    if (!buffer->file) {
+        buffer->file = std::make_unique<QTemporaryFile>(mappingDirectory() + QStringLiteral("/ksanecore-XXXXXX"));
+        if (!buffer->file->open()) {
+            qCWarning(KSANECORE_LOG) << "Failed to create a temporary file for the image:" << buffer->file->errorString();
+            buffer->file.reset();
+            return false;
+        }
+    }
+    if (!buffer->file->resize(size)) {
+        qCWarning(KSANECORE_LOG) << "Failed to resize the temporary file of the image:" << buffer->file->errorString();
+        return false;
+    }
+    uchar *data = buffer->file->map(0, size);
+    if (data == nullptr) {
+        qCWarning(KSANECORE_LOG) << "Failed to map the temporary file of the image:" << buffer->file->errorString();
+        return false;
+    }
+    // when growing, the new mapping shows the content of the file, the previous one is not needed anymore
+    if (buffer->data != nullptr) {
+        buffer->file->unmap(buffer->data);
+    }
+    buffer->data = data;
+    buffer->capacity = size;
+    return true;
+}
+
+std::shared_ptr<ImageBuffer> ImageBufferPool::acquire(qsizetype size)
+{
+    auto buffer = std::make_shared<ImageBuffer>();
+    buffer->pool = weak_from_this();
+
+    // without a file the image is built in memory nevertheless
+    if (isMapped(size) && mapFile(buffer.get(), size)) {
+        return buffer;
+    }
+
+    QMutexLocker locker(&m_mutex);
+    // take the smallest idle buffer which is large enough
+    int bestFit = -1;
+    for (int i = 0; i < m_idleBuffers.size(); i++) {
+        if (m_idleBuffers.at(i).capacity >= size && (bestFit < 0 || m_idleBuffers.at(i).capacity < m_idleBuffers.at(bestFit).capacity)) {
+            bestFit = i;
+        }
+    }
+    if (bestFit >= 0) {
+        const IdleBuffer idleBuffer = m_idleBuffers.takeAt(bestFit);
+        buffer->data = idleBuffer.data;
+        buffer->capacity = idleBuffer.capacity;
+        return buffer;
+    }
+
+    buffer->data = static_cast<uchar *>(malloc(size));
+    if (buffer->data == nullptr) {
+        // the idle buffers are too small anyway, give their memory back and try again
+        for (const IdleBuffer &idleBuffer : std::as_const(m_idleBuffers)) {
+            free(idleBuffer.data);
+        }
+        m_idleBuffers.clear();
+        buffer->data = static_cast<uchar *>(malloc(size));
+    }
+    if (buffer->data == nullptr) {
+        return nullptr;
+    }
+    buffer->capacity = size;
+    return buffer;
+}
+
+bool ImageBufferPool::grow(ImageBuffer *buffer, qsizetype size)
+{
+    if (size <= buffer->capacity) {
+        return true;
+    }
+    if (buffer->file) {
+        if (mapFile(buffer, size)) {
+            return true;
+        }
+        // move the rows into memory if the file cannot grow
+        uchar *data = static_cast<uchar *>(malloc(size));
+        if (data == nullptr) {
+            return false;
+        }
+        memcpy(data, buffer->data, buffer->capacity);
+        buffer->file->unmap(buffer->data);
+        buffer->file.reset();
+        buffer->data = data;
+        buffer->capacity = size;
+        return true;
+    }
+    if (isMapped(size)) {
+        // move the rows of an image which has outgrown the memory into a file
+        ImageBuffer mappedBuffer;
+        if (mapFile(&mappedBuffer, size)) {
+            memcpy(mappedBuffer.data, buffer->data, buffer->capacity);
+            free(buffer->data);
+            buffer->data = mappedBuffer.data;
+            buffer->capacity = mappedBuffer.capacity;
+            buffer->file = std::move(mappedBuffer.file);
+            return true;
+        }
+    }
+    uchar *data = static_cast<uchar *>(realloc(buffer->data, size));
+    if (data == nullptr) {
+        return false;
+    }
+    buffer->data = data;
+    buffer->capacity = size;
+    return true;
+}
+
+QImage ImageBufferPool::wrap(const std::shared_ptr<ImageBuffer> &buffer, int width, int height, qsizetype bytesPerLine, QImage::Format format)
+{
+    auto cleanupInfo = new std::shared_ptr<ImageBuffer>(buffer);
+    QImage image(buffer->data, width, height, bytesPerLine, format, releaseBuffer, cleanupInfo);
+    if (image.isNull()) {
+        releaseBuffer(cleanupInfo);
+    }
+    return image;
+}
+
+void ImageBufferPool::releaseBuffer(void *info)
+{
+    auto buffer = static_cast<std::shared_ptr<ImageBuffer> *>(info);
+    if ((*buffer)->data != nullptr && (*buffer)->file) {
+        // mapped buffers are not recycled, the file is removed with the buffer
+        (*buffer)->file->unmap((*buffer)->data);
+        (*buffer)->data = nullptr;
+    } else if ((*buffer)->data != nullptr) {
+        if (const auto pool = (*buffer)->pool.lock()) {
+            pool->recycle((*buffer)->data, (*buffer)->capacity);
+        } else {
+            free((*buffer)->data);
+        }
+        (*buffer)->data = nullptr;
+    }
+    delete buffer;
+}
+
+void ImageBufferPool::recycle(uchar *data, qsizetype capacity)
+{
+    QMutexLocker locker(&m_mutex);
+    if (m_idleBuffers.size() < m_maxIdleBuffers) {
+        m_idleBuffers.append({data, capacity});
+        return;
+    }
+    // replace the smallest idle buffer if this one is larger
+    int smallest = 0;
+    for (int i = 1; i < m_idleBuffers.size(); i++) {
+        if (m_idleBuffers.at(i).capacity < m_idleBuffers.at(smallest).capacity) {
+            smallest = i;
+        }
+    }
+    if (!m_idleBuffers.isEmpty() && m_idleBuffers.at(smallest).capacity < capacity) {
+        std::swap(m_idleBuffers[smallest].data, data);
+        m_idleBuffers[smallest].capacity = capacity;
+    }
+    free(data);
+}
+
+} // namespace KSaneCore
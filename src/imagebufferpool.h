@@ -0,0 +1,75 @@
+/*
+ * SPDX-FileCopyrightText: 2026 KSaneCore authors
+ *
+ * SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+ */
+
+#ifndef KSANE_IMAGE_BUFFER_POOL_H
+#define KSANE_IMAGE_BUFFER_POOL_H
+
+#include <QImage>
+#include <QList>
+#include <QMutex>
+#include <QTemporaryFile>
+
+#include <memory>
+
+namespace KSaneCore
+{
+
+class ImageBufferPool;
+
+/* Memory backing an image allocated by the ImageBuilder. The QImage
+ * wrapping the memory hands it back to the pool when the last copy of
+ * the image is destroyed. Large buffers map a temporary file instead of
+ * allocating memory, the file is removed together with the buffer. */
+struct ImageBuffer {
+    uchar *data = nullptr;
+    qsizetype capacity = 0;
+    std::unique_ptr<QTemporaryFile> file;
+    std::weak_ptr<ImageBufferPool> pool;
+};
+
+/* Keeps the buffers of delivered pages once the application has released
+ * them, so that the following pages of a batch scan reuse the memory
+ * instead of allocating it again. */
+class ImageBufferPool : public std::enable_shared_from_this<ImageBufferPool>
+{
+public:
+    explicit ImageBufferPool(int maxIdleBuffers = 2);
+    ~ImageBufferPool();
+
+    /* Buffers larger than the threshold are backed by a memory-mapped temporary file in the
+     * cache directory, so that the system can page out their rows. Buffers are allocated in
+     * memory if the file cannot be used. 0 allocates all buffers in memory. */
+    void setMappingThreshold(qsizetype size);
+
+    /* Returns a buffer of at least size bytes, reusing an idle buffer if possible */
+    std::shared_ptr<ImageBuffer> acquire(qsizetype size);
+
+    /* Grows the buffer to at least size bytes, keeping its content */
+    bool grow(ImageBuffer *buffer, qsizetype size);
+
+    /* Wraps the buffer in a QImage which returns the buffer to its pool when it is destroyed */
+    static QImage wrap(const std::shared_ptr<ImageBuffer> &buffer, int width, int height, qsizetype bytesPerLine, QImage::Format format);
+
+private:
+    static void releaseBuffer(void *info);
+    void recycle(uchar *data, qsizetype capacity);
+    bool isMapped(qsizetype size);
+    static bool mapFile(ImageBuffer *buffer, qsizetype size);
+
+    struct IdleBuffer {
+        uchar *data;
+        qsizetype capacity;
+    };
+
+    const int m_maxIdleBuffers;
+    qsizetype m_mappingThreshold = 0;
+    QList<IdleBuffer> m_idleBuffers;
+    QMutex m_mutex;
+};
+
+} // namespace KSaneCore
+
+#endif // KSANE_IMAGE_BUFFER_POOL_H
@@ -10,12 +10,33 @@
 
 #include <QImage>
 
+#include <algorithm>
+#include <limits>
+
 #include <ksanecore_debug.h>
 
+#include "imagekernels.h"
+
 namespace KSaneCore
 {
+
+// rows are handed to a sink in bands of about this size
+static constexpr qsizetype SinkBandBytes = 4 * 1024 * 1024;
+
+template<int Bytes>
+static void copyUnits(const uchar *source, uchar *destination, int units)
+{
+    memcpy(destination, source, units * Bytes);
+}
+
+template<int Bytes>
+static void invertUnits(const uchar *source, uchar *destination, int units)
+{
+    ImageKernels::xorBytes(source, destination, units * Bytes, ~quint64(0));
+}
+
 ImageBuilder::ImageBuilder(QImage *image, int *dpi)
-    : m_image(image), m_dpi(dpi)
+    : m_params(), m_image(image), m_bufferPool(std::make_shared<ImageBufferPool>()), m_dpi(dpi)
 {
     m_pixelData[0] = 0;
     m_pixelData[1] = 0;
@@ -25,36 +46,34 @@ ImageBuilder::ImageBuilder(QImage *image, int *dpi)
     m_pixelData[5] = 0;
 }
 
-void ImageBuilder::start(const SANE_Parameters &params)
+bool ImageBuilder::start(const SANE_Parameters &params)
 {
+    m_imageFormat = selectImageFormat(params, m_outputFormat);
     beginFrame(params);
-    QImage::Format imageFormat = QImage::Format_RGB32;
-    if (m_params.format == SANE_FRAME_GRAY) {
-        switch (m_params.depth) {
-        case 1:
-            imageFormat = QImage::Format_Mono;
-            break;
-        case 16:
-            imageFormat = QImage::Format_Grayscale16;
-            break;
-        default:
-            imageFormat = QImage::Format_Grayscale8;
-            break;
-        }
-    } else if (m_params.depth > 8) {
-        imageFormat = QImage::Format_RGBX64;
+
+    int pixelLines = m_params.lines;
+    // handscanners have the number of lines -1 -> make room for something
+    if (m_params.lines <= 0) {
+        pixelLines = m_params.pixels_per_line;
     }
+    // three-pass frames cover the whole page, only single-pass pages are passed to a sink in bands
+    m_pageSink = m_sink;
+    m_sinkFailed = false;
+    m_banded = m_sink != nullptr && (m_params.format == SANE_FRAME_GRAY || m_params.format == SANE_FRAME_RGB);
+    m_bandOffset = 0;
+    if (m_banded) {
+        const qsizetype bytesPerLine = ((qsizetype(m_params.pixels_per_line) * QImage::toPixelFormat(m_imageFormat).bitsPerPixel() + 31) / 32) * 4;
+        pixelLines = qBound(1, int(SinkBandBytes / qMax(bytesPerLine, qsizetype(1))), qMax(pixelLines, 1));
+    }
+
     // create a new image if necessary
-    if ((m_image->height() != m_params.lines) ||
-            (m_image->width() != m_params.pixels_per_line) || m_image->format() != imageFormat) {
+    if ((m_image->height() != pixelLines) ||
+            (m_image->width() != m_params.pixels_per_line) || m_image->format() != m_imageFormat) {
         // just hope that the frame size is not changed between different frames of the same image.
-
-        int pixelLines = m_params.lines;
-        // handscanners have the number of lines -1 -> make room for something
-        if (m_params.lines <= 0) {
-            pixelLines = m_params.pixels_per_line;
+        if (!allocateImage(m_params.pixels_per_line, pixelLines, m_imageFormat)) {
+            m_pageSink = nullptr;
+            return false;
         }
-        *m_image = QImage(m_params.pixels_per_line, pixelLines, imageFormat);
         if (m_image->format() == QImage::Format_Mono) {
             m_image->setColorTable(QVector<QRgb>({0xFFFFFFFF,0xFF000000}));
         }
@@ -62,220 +81,551 @@ void ImageBuilder::start(const SANE_Parameters &params)
         m_image->setDotsPerMeterX(dpm);
         m_image->setDotsPerMeterY(dpm);
     }
-    m_image->fill(0xFFFFFFFF);
+    // the image is not filled in advance, rows which never receive data are filled by fillUnwrittenArea(),
+    // abortPage() or, while the image is shown during the scan, by fillUndecodedArea()
+    m_initializedPixels = 0;
+    m_imageComplete = false;
+    m_filledBytes = 0;
+    m_directWriteEnd = 0;
+
+    if (m_pageSink != nullptr && !m_pageSink->beginPage(m_params.pixels_per_line, m_params.lines > 0 ? m_params.lines : -1, m_imageFormat, *m_dpi)) {
+        qCWarning(KSANECORE_LOG) << "The scan sink has refused the page";
+        m_sinkFailed = true;
+    }
+    return true;
 }
 
 void ImageBuilder::beginFrame(const SANE_Parameters &params)
 {
     m_params = params;
+    m_decoder = selectDecoder(m_params, m_imageFormat, m_invertColors);
     m_frameRead  = 0;
-    m_pixelX    = 0;
+    m_rowUnits = m_params.depth == 1 ? (m_params.pixels_per_line + 7) / 8 : m_params.pixels_per_line;
+    m_unitX = 0;
     m_pixelY    = 0;
+    m_row = nullptr;
     m_pixelDataIndex = 0;
 }
 
-bool ImageBuilder::copyToImage(const SANE_Byte readData[], int read_bytes)
+void ImageBuilder::setInvertColors(bool invert)
+{
+    if (m_invertColors == invert) {
+        return;
+    }
+    m_invertColors = invert;
+    m_decoder = selectDecoder(m_params, m_imageFormat, m_invertColors);
+
+    // invert the pixels decoded so far, the remaining ones are inverted while decoding;
+    // this rewrites rows which have been reported as completed already
+    const qsizetype bytes = decodedBytes();
+    if (bytes > 0) {
+        quint64 pattern = ~quint64(0);
+        if (m_image->format() == QImage::Format_RGB32) {
+            pattern = 0x00FFFFFF00FFFFFFULL;
+        } else if (m_image->format() == QImage::Format_RGBX64) {
+            pattern = 0x0000FFFFFFFFFFFFULL;
+        }
+        uchar *bits = m_image->bits();
+        ImageKernels::xorBytes(bits, bits, bytes, pattern);
+    }
+}
+
+void ImageBuilder::setOutputFormat(Interface::OutputFormat format)
+{
+    // takes effect with the next call of start()
+    m_outputFormat = format;
+}
+
+void ImageBuilder::setSink(ScanSink *sink)
+{
+    // takes effect with the next call of start()
+    m_sink = sink;
+}
+
+void ImageBuilder::setMemoryBudget(qsizetype bytes)
+{
+    // larger images are built in a memory-mapped file
+    m_bufferPool->setMappingThreshold(bytes);
+}
+
+QImage::Format ImageBuilder::selectImageFormat(const SANE_Parameters &params, Interface::OutputFormat outputFormat)
+{
+    if (params.format == SANE_FRAME_GRAY) {
+        switch (params.depth) {
+        case 1:
+            return QImage::Format_Mono;
+        case 16:
+            return QImage::Format_Grayscale16;
+        default:
+            return QImage::Format_Grayscale8;
+        }
+    } else if (params.depth > 8) {
+        return QImage::Format_RGBX64;
+    } else if (params.format == SANE_FRAME_RGB) {
+        // three-pass frames are always assembled in the native format
+        switch (outputFormat) {
+        case Interface::RGB888OutputFormat:
+            return QImage::Format_RGB888;
+        case Interface::Grayscale8OutputFormat:
+            return QImage::Format_Grayscale8;
+        case Interface::NativeOutputFormat:
+            break;
+        }
+    }
+    return QImage::Format_RGB32;
+}
+
+ImageBuilder::Decoder ImageBuilder::selectDecoder(const SANE_Parameters &params, QImage::Format imageFormat, bool invert)
 {
-    switch (m_params.format) {
+    // Format_RGB32 stores blue, green and red in the bytes 0 to 2, Format_RGBX64 uses the reverse order
+    switch (params.format) {
     case SANE_FRAME_GRAY:
-        if (m_params.depth == 1) {
-            for (int i = 0; i < read_bytes; i++) {
-                if (m_pixelY >= m_image->height()) {
-                    renewImage();
-                }
-                uchar *imageBits = m_image->scanLine(m_pixelY);
-                imageBits[m_pixelX / 8] = readData[i];
-                m_pixelX += 8;
-                if (m_pixelX >= m_params.pixels_per_line) {
-                    m_pixelX = 0;
-                    m_pixelY++;
-                }
-                m_frameRead++;
-            }
-            return true;
-        } else if (m_params.depth == 8) {
-            for (int i = 0; i < read_bytes; i++) {
-                if (m_pixelY >= m_image->height()) {
-                    renewImage();
-                }
-                uchar *grayScale = m_image->scanLine(m_pixelY);
-                grayScale[m_pixelX] = readData[i];
-                incrementPixelData();
-                m_frameRead++;
-            }
-            return true;
-        } else if (m_params.depth == 16) {
-            for (int i = 0; i < read_bytes; i++) {
-                m_pixelData[m_pixelDataIndex] = readData[i];
-                m_pixelDataIndex++;
-                if (m_pixelDataIndex == 2) {
-                    m_pixelDataIndex = 0;
-                }
-                if (m_pixelDataIndex == 0) {
-                    if (m_pixelY >= m_image->height()) {
-                        renewImage();
-                    }
-                    quint16 *grayScale = reinterpret_cast<quint16*>(m_image->scanLine(m_pixelY));
-                    grayScale[m_pixelX] = m_pixelData[0] + (m_pixelData[1] << 8);
-                    incrementPixelData();
-                }
-                m_frameRead++;
-            }
-            return true;
+        if (params.depth == 1 || params.depth == 8) {
+            return invert ? &ImageBuilder::decodePacked<1, 1, invertUnits<1>> : &ImageBuilder::decodePacked<1, 1, copyUnits<1>>;
+        } else if (params.depth == 16) {
+            return invert ? &ImageBuilder::decodePacked<2, 2, invertUnits<2>> : &ImageBuilder::decodePacked<2, 2, copyUnits<2>>;
         }
         break;
-
     case SANE_FRAME_RGB:
-        if (m_params.depth == 8) {
-            for (int i = 0; i < read_bytes; i++) {
-                m_pixelData[m_pixelDataIndex] = readData[i];
-                m_pixelDataIndex++;
-                if (m_pixelDataIndex == 3) {
-                    m_pixelDataIndex = 0;
-                }
-                if (m_pixelDataIndex == 0) {
-                    if (m_pixelY >= m_image->height()) {
-                        renewImage();
-                    }
-                    QRgb *rgbData = reinterpret_cast<QRgb*>(m_image->scanLine(m_pixelY));
-                    rgbData[m_pixelX] = qRgb(m_pixelData[0], m_pixelData[1], m_pixelData[2]);
-                    incrementPixelData();
-                }
-                m_frameRead++;
-            }
-            return true;
-        } else if (m_params.depth == 16) {
-            for (int i = 0; i < read_bytes; i++) {
-                m_pixelData[m_pixelDataIndex] = readData[i];
-                m_pixelDataIndex++;
-                if (m_pixelDataIndex == 6) {
-                    m_pixelDataIndex = 0;
-                }
-                if (m_pixelDataIndex == 0) {
-                    if (m_pixelY >= m_image->height()) {
-                        renewImage();
-                    }
-                    QRgba64 *rgbData = reinterpret_cast<QRgba64*>(m_image->scanLine(m_pixelY));
-                    rgbData[m_pixelX] = QRgba64::fromRgba64((m_pixelData[0] + (m_pixelData[1] << 8)),
-                                                            (m_pixelData[2] + (m_pixelData[3] << 8)),
-                                                            (m_pixelData[4] + (m_pixelData[5] << 8)),
-                                                            0xFFFF);
-                    incrementPixelData();
-                }
-                m_frameRead++;
-            }
-            return true;
+        if (params.depth == 8 && imageFormat == QImage::Format_RGB888) {
+            return invert ? &ImageBuilder::decodePacked<3, 3, invertUnits<3>> : &ImageBuilder::decodePacked<3, 3, copyUnits<3>>;
+        } else if (params.depth == 8 && imageFormat == QImage::Format_Grayscale8) {
+            return invert ? &ImageBuilder::decodePacked<3, 1, ImageKernels::rgb8ToGray8<true>>
+                          : &ImageBuilder::decodePacked<3, 1, ImageKernels::rgb8ToGray8<false>>;
+        } else if (params.depth == 8) {
+            return invert ? &ImageBuilder::decodePacked<3, 4, ImageKernels::rgb8ToRgb32<true>>
+                          : &ImageBuilder::decodePacked<3, 4, ImageKernels::rgb8ToRgb32<false>>;
+        } else if (params.depth == 16) {
+            return invert ? &ImageBuilder::decodePacked<6, 8, ImageKernels::rgb16ToRgbx64<true>>
+                          : &ImageBuilder::decodePacked<6, 8, ImageKernels::rgb16ToRgbx64<false>>;
         }
         break;
-
-    case SANE_FRAME_RED: {
-        int index = 0;
-        if (m_params.depth == 8) {
-            for (int i = 0; i < read_bytes; i++) {
-                index = m_frameRead * 4 + 2;
-                if (index >= m_image->sizeInBytes()) {
-                    renewImage();
-                }
-                m_image->bits()[index] = readData[i];
-                m_frameRead++;
-            }
-            return true;
-        } else if (m_params.depth == 16) {
-            for (int i = 0; i < read_bytes; i++) {
-                index = (m_frameRead - m_frameRead % 2) * 4 + m_frameRead % 2;
-                if (index >= m_image->sizeInBytes()) {
-                    renewImage();
-                }
-                m_image->bits()[index] = readData[i];
-                m_frameRead++;
-            }
-            return true;
+    case SANE_FRAME_RED:
+        if (params.depth == 8) {
+            return invert ? &ImageBuilder::decodePlanar<1, 2, true> : &ImageBuilder::decodePlanar<1, 2, false>;
+        } else if (params.depth == 16) {
+            return invert ? &ImageBuilder::decodePlanar<2, 0, true> : &ImageBuilder::decodePlanar<2, 0, false>;
         }
         break;
-    }
-    case SANE_FRAME_GREEN: {
-        int index = 0;
-        if (m_params.depth == 8) {
-            for (int i = 0; i < read_bytes; i++) {
-                int index = m_frameRead * 4 + 1;
-                if (index >= m_image->sizeInBytes()) {
-                    renewImage();
-                }
-                m_image->bits()[index] = readData[i];
-                m_frameRead++;
-            }
-            return true;
-        } else if (m_params.depth == 16) {
-            for (int i = 0; i < read_bytes; i++) {
-                index = (m_frameRead - m_frameRead % 2) * 4 + 2 + m_frameRead % 2;
-                if (index >= m_image->sizeInBytes()) {
-                    renewImage();
-                }
-                m_image->bits()[index] = readData[i];
-                m_frameRead++;
-            }
-            return true;
+    case SANE_FRAME_GREEN:
+        if (params.depth == 8) {
+            return invert ? &ImageBuilder::decodePlanar<1, 1, true> : &ImageBuilder::decodePlanar<1, 1, false>;
+        } else if (params.depth == 16) {
+            return invert ? &ImageBuilder::decodePlanar<2, 1, true> : &ImageBuilder::decodePlanar<2, 1, false>;
+        }
+        break;
+    case SANE_FRAME_BLUE:
+        if (params.depth == 8) {
+            return invert ? &ImageBuilder::decodePlanar<1, 0, true> : &ImageBuilder::decodePlanar<1, 0, false>;
+        } else if (params.depth == 16) {
+            return invert ? &ImageBuilder::decodePlanar<2, 2, true> : &ImageBuilder::decodePlanar<2, 2, false>;
         }
         break;
     }
-    case SANE_FRAME_BLUE: {
-        int index = 0;
-        if (m_params.depth == 8) {
-            for (int i = 0; i < read_bytes; i++) {
-                int index = m_frameRead * 4;
-                if (index >= m_image->sizeInBytes()) {
-                    renewImage();
-                }
-                m_image->bits()[index] = readData[i];
-                m_frameRead++;
-            }
-            return true;
-        } else if (m_params.depth == 16) {
-            for (int i = 0; i < read_bytes; i++) {
-                index = (m_frameRead - m_frameRead % 2) * 4 + 4 + m_frameRead % 2;
-                if (index >= m_image->sizeInBytes()) {
-                    renewImage();
-                }
-                m_image->bits()[index] = readData[i];
-                m_frameRead++;
-            }
+    return nullptr;
+}
+
+bool ImageBuilder::copyToImage(const SANE_Byte readData[], int read_bytes)
+{
+    if (m_decoder == nullptr) {
+        qCWarning(KSANECORE_LOG) << "Format" << m_params.format << "and depth" << m_params.depth << "is not yet supported by libksane!";
+        return false;
+    }
+    if (m_sinkFailed) {
+        return false;
+    }
+    // the image might have been shared in between two chunks, so fetch the row pointer again
+    m_row = nullptr;
+    return (this->*m_decoder)(readData, read_bytes);
+}
+
+/* Returns the part of the image the next data can be read into, or nullptr if the data has to be
+ * passed to copyToImage(). maxBytes is the size of the read, it is reduced to the available space. */
+SANE_Byte *ImageBuilder::directWriteBuffer(int *maxBytes)
+{
+    // Gray and line art data can be read directly into the image if the layout of the rows is identical
+    if (m_params.format != SANE_FRAME_GRAY || (m_params.depth != 1 && m_params.depth != 8) || m_banded) {
+        return nullptr;
+    }
+    if (m_params.bytes_per_line != m_rowUnits || m_params.bytes_per_line != m_image->bytesPerLine()) {
+        return nullptr;
+    }
+    // the image is full, the data has to go through copyToImage() which enlarges the image
+    const qsizetype available = m_image->sizeInBytes() - m_frameRead;
+    if (available <= 0) {
+        return nullptr;
+    }
+    *maxBytes = int(qMin(available, qsizetype(*maxBytes)));
+    m_directWriteEnd = m_frameRead + *maxBytes;
+    return m_image->bits() + m_frameRead;
+}
+
+void ImageBuilder::commitDirectWrite(int bytes)
+{
+    if (m_invertColors) {
+        uchar *data = m_image->bits() + m_frameRead;
+        ImageKernels::xorBytes(data, data, bytes, ~quint64(0));
+    }
+    m_frameRead += bytes;
+    m_pixelY = int(m_frameRead / m_params.bytes_per_line);
+    m_unitX = int(m_frameRead % m_params.bytes_per_line);
+    m_row = nullptr;
+    // fillUndecodedArea() has left out the part that had been handed out for reading
+    if (m_filledBytes > 0 && m_directWriteEnd > m_frameRead) {
+        fillWhite(m_frameRead, m_directWriteEnd);
+    }
+    m_directWriteEnd = 0;
+}
+
+inline uchar *ImageBuilder::currentRow()
+{
+    if (m_row == nullptr) {
+        // a full band is handed to the sink and then reused for the following rows
+        if (m_pixelY >= m_image->height() && !(m_banded ? writeBand(m_image->height()) : renewImage())) {
+            return nullptr;
+        }
+        m_row = m_image->scanLine(m_pixelY);
+    }
+    return m_row;
+}
+
+inline void ImageBuilder::advance(int units)
+{
+    m_unitX += units;
+    if (m_unitX >= m_rowUnits) {
+        m_unitX = 0;
+        m_pixelY++;
+        m_row = nullptr;
+    }
+}
+
+template<int InputBytes, int OutputBytes, ImageBuilder::PixelConverter Convert>
+bool ImageBuilder::decodePacked(const SANE_Byte readData[], int read_bytes)
+{
+    m_frameRead += read_bytes;
+
+    // complete the pixel that was split at the end of the previous chunk
+    if (m_pixelDataIndex > 0) {
+        const int missingBytes = qMin(InputBytes - m_pixelDataIndex, read_bytes);
+        memcpy(m_pixelData + m_pixelDataIndex, readData, missingBytes);
+        m_pixelDataIndex += missingBytes;
+        readData += missingBytes;
+        read_bytes -= missingBytes;
+        if (m_pixelDataIndex < InputBytes) {
             return true;
         }
-        break;
+        m_pixelDataIndex = 0;
+        uchar *row = currentRow();
+        if (row == nullptr) {
+            return false;
+        }
+        Convert(m_pixelData, row + m_unitX * OutputBytes, 1);
+        advance(1);
     }
+
+    // convert all complete pixels row by row
+    while (read_bytes >= InputBytes) {
+        uchar *row = currentRow();
+        if (row == nullptr) {
+            return false;
+        }
+        const int units = qMin(read_bytes / InputBytes, m_rowUnits - m_unitX);
+        Convert(readData, row + m_unitX * OutputBytes, units);
+        readData += units * InputBytes;
+        read_bytes -= units * InputBytes;
+        advance(units);
     }
 
-    qCWarning(KSANECORE_LOG) << "Format" << m_params.format << "and depth" << m_params.depth << "is not yet supported by libksane!";
-    return false;
+    // keep the remaining bytes of an incomplete pixel for the next chunk
+    if (read_bytes > 0) {
+        memcpy(m_pixelData, readData, read_bytes);
+        m_pixelDataIndex = read_bytes;
+    }
+    return true;
 }
 
-void ImageBuilder::renewImage()
+template<int SampleBytes, int Channel, bool Invert>
+bool ImageBuilder::decodePlanar(const SANE_Byte readData[], int read_bytes)
 {
-    int start = m_image->sizeInBytes();
+    // the image has no padding at the end of the rows, so the samples map linearly to the pixels
+    const qsizetype pixelsTouched = (m_frameRead + read_bytes + SampleBytes - 1) / SampleBytes;
+    while (pixelsTouched * SampleBytes * 4 > m_image->sizeInBytes()) {
+        if (!renewImage()) {
+            return false;
+        }
+    }
 
-    // resize the image
-    *m_image = m_image->copy(0, 0, m_image->width(), m_image->height() + m_image->width());
+    // fetch the pointer only once, bits() might detach the image
+    uchar *bits = m_image->bits();
 
-    for (int i = start; i < m_image->sizeInBytes(); i++) { // New parts are filled with "transparent black"
-        m_image->bits()[i] = 0xFF; // Change to opaque white (0xFFFFFFFF), or white, whatever the format is
+    // the image is not initialized in advance, set all channels of a pixel to white the first time it is touched
+    if (pixelsTouched > m_initializedPixels) {
+        memset(bits + m_initializedPixels * SampleBytes * 4, 0xFF, (pixelsTouched - m_initializedPixels) * SampleBytes * 4);
+        m_initializedPixels = pixelsTouched;
     }
+
+    scatterSamples<SampleBytes, Channel, Invert>(readData, read_bytes, bits);
+    return true;
 }
 
-void ImageBuilder::cropImagetoSize()
+template<int SampleBytes, int Channel, bool Invert>
+void ImageBuilder::scatterSamples(const SANE_Byte readData[], int read_bytes, uchar *bits)
 {
-    int height = m_pixelY ? m_pixelY : m_frameRead / m_params.bytes_per_line;
-    if (m_image->height() == height)
+    constexpr int pixelBytes = SampleBytes * 4;
+    constexpr SANE_Byte mask = Invert ? 0xFF : 0x00;
+    if constexpr (SampleBytes == 1) {
+        ImageKernels::scatterChannel8<Invert>(readData, bits + m_frameRead * pixelBytes, Channel, read_bytes);
+        m_frameRead += read_bytes;
+    } else {
+        // complete a 16 bit sample that was split at the end of the previous chunk
+        if (m_frameRead % 2 != 0 && read_bytes > 0) {
+            bits[(m_frameRead / 2) * pixelBytes + Channel * 2 + 1] = readData[0] ^ mask;
+            m_frameRead++;
+            readData++;
+            read_bytes--;
+        }
+        const int samples = read_bytes / 2;
+        ImageKernels::scatterChannel16<Invert>(readData, bits + (m_frameRead / 2) * pixelBytes, Channel, samples);
+        m_frameRead += samples * 2;
+        if (read_bytes % 2 != 0) {
+            bits[(m_frameRead / 2) * pixelBytes + Channel * 2] = readData[read_bytes - 1] ^ mask;
+            m_frameRead++;
+        }
+    }
+}
+
+bool ImageBuilder::renewImage()
+{
+    // grow the image geometrically, so that copying the rows costs a constant amount per row
+    const int oldHeight = m_image->height();
+    return resizeImage(oldHeight + qMax(oldHeight / 2, m_image->width())) && m_image->height() > oldHeight;
+}
+
+bool ImageBuilder::writeBand(int rows)
+{
+    // a full band is passed without copying it, the rows of a partial band are copied
+    const bool written = m_pageSink->writeRows(m_bandOffset, rows == m_image->height() ? *m_image : m_image->copy(0, 0, m_image->width(), rows));
+    if (!written) {
+        qCWarning(KSANECORE_LOG) << "The scan sink has failed to write the rows" << m_bandOffset << "to" << m_bandOffset + rows - 1;
+        m_sinkFailed = true;
+        return false;
+    }
+    m_bandOffset += rows;
+    m_pixelY = 0;
+    m_row = nullptr;
+    return true;
+}
+
+bool ImageBuilder::finishSinkPage()
+{
+    if (m_pageSink == nullptr) {
+        return true;
+    }
+    if (m_sinkFailed) {
+        return false;
+    }
+    // the page has been assembled completely in the image
+    if (!m_image->isNull() && !m_pageSink->writeRows(0, *m_image)) {
+        qCWarning(KSANECORE_LOG) << "The scan sink has failed to write the page";
+        m_sinkFailed = true;
+        return false;
+    }
+    return endSinkPage(m_image->height());
+}
+
+bool ImageBuilder::endSinkPage(int height)
+{
+    ScanSink *sink = m_pageSink;
+    m_pageSink = nullptr;
+    // the rows have been handed over, the memory of the image is reused for the next page
+    *m_image = QImage();
+    if (!sink->endPage(height)) {
+        qCWarning(KSANECORE_LOG) << "The scan sink has failed to finish the page";
+        m_sinkFailed = true;
+        return false;
+    }
+    return true;
+}
+
+void ImageBuilder::abortPage()
+{
+    // the rows which have not been scanned do not show the memory of a previous page
+    if (!m_image->isNull() && !m_imageComplete && !m_banded) {
+        fillWhite(decodedBytes(), m_image->sizeInBytes());
+        m_imageComplete = true;
+    }
+    if (m_pageSink != nullptr) {
+        m_pageSink->abortPage();
+        m_pageSink = nullptr;
+    }
+}
+
+bool ImageBuilder::allocateImage(int width, int height, QImage::Format format)
+{
+    const qsizetype bytesPerLine = ((qsizetype(width) * QImage::toPixelFormat(format).bitsPerPixel() + 31) / 32) * 4;
+    if (width > (std::numeric_limits<int>::max() - 31) / QImage::toPixelFormat(format).bitsPerPixel()
+            || height > std::numeric_limits<qsizetype>::max() / bytesPerLine) {
+        qCWarning(KSANECORE_LOG) << "An image of" << width << "x" << height << "pixels exceeds the limits of QImage, a scan sink has to be used";
+        *m_image = QImage();
+        return false;
+    }
+    const auto buffer = m_bufferPool->acquire(bytesPerLine * height);
+    if (!buffer) {
+        qCWarning(KSANECORE_LOG) << "Failed to allocate an image of" << width << "x" << height << "pixels";
+        *m_image = QImage();
+        return false;
+    }
+    m_buffer = buffer;
+    *m_image = ImageBufferPool::wrap(buffer, width, height, bytesPerLine, format);
+    return !m_image->isNull();
+}
+
+bool ImageBuilder::resizeImage(int height)
+{
+    if (m_image->isNull()) {
+        return false;
+    }
+    const int oldHeight = m_image->height();
+    const int width = m_image->width();
+    const qsizetype bytesPerLine = m_image->bytesPerLine();
+    const QImage::Format format = m_image->format();
+    const QList<QRgb> colorTable = m_image->colorTable();
+    const int dotsPerMeterX = m_image->dotsPerMeterX();
+    const int dotsPerMeterY = m_image->dotsPerMeterY();
+    bool resized = true;
+
+    auto buffer = m_buffer.lock();
+    if (buffer && buffer->data == m_image->constBits() && m_image->isDetached()) {
+        // nobody else uses the buffer, so it can be resized in place without copying the rows;
+        // when cropping, the capacity is kept so that the buffer can be recycled for the next page
+        uchar *data = buffer->data;
+        buffer->data = nullptr;
+        *m_image = QImage();
+        buffer->data = data;
+        if (!m_bufferPool->grow(buffer.get(), bytesPerLine * height)) {
+            qCWarning(KSANECORE_LOG) << "Failed to resize the image to" << width << "x" << height << "pixels";
+            resized = false;
+            height = oldHeight;
+        }
+    } else {
+        buffer = m_bufferPool->acquire(bytesPerLine * height);
+        if (!buffer) {
+            // keep the current image
+            qCWarning(KSANECORE_LOG) << "Failed to resize the image to" << width << "x" << height << "pixels";
+            return false;
+        }
+        memcpy(buffer->data, m_image->constBits(), bytesPerLine * qMin(height, oldHeight));
+        m_buffer = buffer;
+    }
+
+    *m_image = ImageBufferPool::wrap(buffer, width, height, bytesPerLine, format);
+    m_image->setColorTable(colorTable);
+    m_image->setDotsPerMeterX(dotsPerMeterX);
+    m_image->setDotsPerMeterY(dotsPerMeterY);
+    m_row = nullptr;
+    return resized && !m_image->isNull();
+}
+
+qsizetype ImageBuilder::decodedBytes() const
+{
+    if (m_imageComplete) {
+        return m_image->sizeInBytes();
+    }
+    qsizetype decoded;
+    if (m_params.format == SANE_FRAME_RED || m_params.format == SANE_FRAME_GREEN || m_params.format == SANE_FRAME_BLUE) {
+        decoded = m_initializedPixels * (m_image->depth() / 8);
+    } else {
+        decoded = m_pixelY * m_image->bytesPerLine() + m_unitX * qMax(m_image->depth() / 8, 1);
+    }
+    return qMin(decoded, m_image->sizeInBytes());
+}
+
+bool ImageBuilder::sinkFailed() const
+{
+    return m_sinkFailed;
+}
+
+int ImageBuilder::completedRows() const
+{
+    // the rows of a page passed to a sink are not kept in the image
+    if (m_banded || m_pageSink != nullptr) {
+        return 0;
+    }
+    if (m_imageComplete) {
+        return m_image->height();
+    }
+    int rows = m_pixelY;
+    if (m_params.format == SANE_FRAME_RED || m_params.format == SANE_FRAME_GREEN || m_params.format == SANE_FRAME_BLUE) {
+        rows = int(m_frameRead / m_params.bytes_per_line);
+    }
+    return qMin(rows, m_image->height());
+}
+
+void ImageBuilder::fillWhite(qsizetype from, qsizetype to)
+{
+    // opaque white for all formats besides line art, where white is the color with index 0
+    const int white = m_image->format() == QImage::Format_Mono ? 0x00 : 0xFF;
+    if (from < to) {
+        memset(m_image->bits() + from, white, to - from);
+    }
+}
+
+bool ImageBuilder::fillUnwrittenArea()
+{
+    fillWhite(decodedBytes(), m_image->sizeInBytes());
+    m_imageComplete = true;
+    if (!m_banded || m_sinkFailed) {
+        return finishSinkPage();
+    }
+
+    // pass the partly written band, followed by white rows up to the expected height of the page
+    const int height = qMax(m_bandOffset + m_pixelY + (m_unitX > 0 ? 1 : 0), m_params.lines);
+    while (m_bandOffset < height) {
+        if (!writeBand(qMin(height - m_bandOffset, m_image->height()))) {
+            return false;
+        }
+        fillWhite(0, m_image->sizeInBytes());
+    }
+    return endSinkPage(height);
+}
+
+void ImageBuilder::fillUndecodedArea()
+{
+    // the rows of a page passed to a sink are not kept in the image
+    if (m_image->isNull() || m_imageComplete || m_banded) {
         return;
-    *m_image = m_image->copy(0, 0, m_image->width(), height);
+    }
+    // the part which is being read into directly is filled once the read has been committed,
+    // the image is only filled once unless it has been enlarged
+    fillWhite(std::max({decodedBytes(), m_directWriteEnd, m_filledBytes}), m_image->sizeInBytes());
+    m_filledBytes = m_image->sizeInBytes();
 }
 
-void ImageBuilder::incrementPixelData()
+bool ImageBuilder::cropImagetoSize()
 {
-    m_pixelX++;
-    if (m_pixelX >= m_params.pixels_per_line) {
-        m_pixelY++;
-        m_pixelX=0;
+    m_imageComplete = true;
+    if (m_sinkFailed) {
+        return false;
+    }
+    if (m_banded) {
+        // pass the rows of the last band
+        const int height = m_bandOffset + m_pixelY;
+        if (m_pixelY > 0 && !writeBand(m_pixelY)) {
+            return false;
+        }
+        return endSinkPage(height);
+    }
+
+    int height = m_pixelY ? m_pixelY : int(m_frameRead / m_params.bytes_per_line);
+    if (height <= 0) {
+        *m_image = QImage();
+    } else if (m_image->height() != height) {
+        // truncate the image, the rows are only copied if the image is shared
+        if (!resizeImage(height)) {
+            return false;
+        }
     }
+    return finishSinkPage();
 }
 
 } // namespace KSaneCore
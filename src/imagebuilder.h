@@ -14,7 +14,13 @@ extern "C"
 #include <sane/sane.h>
 }
 
-class QImage;
+#include <QImage>
+
+#include <memory>
+
+#include "imagebufferpool.h"
+#include "interface.h"
+#include "scansink.h"
 
 namespace KSaneCore
 {
@@ -25,24 +31,81 @@ class ImageBuilder
 public:
     ImageBuilder(QImage *image, int *dpi);
 
-    void start(const SANE_Parameters &params);
+    bool start(const SANE_Parameters &params);
     void beginFrame(const SANE_Parameters &params);
     bool copyToImage(const SANE_Byte readData[], int read_bytes);
+    SANE_Byte *directWriteBuffer(int *maxBytes);
+    void commitDirectWrite(int bytes);
     void setDPI(int dpi);
-    void cropImagetoSize();
+    void setInvertColors(bool invert);
+    void setOutputFormat(Interface::OutputFormat format);
+    void setSink(ScanSink *sink);
+    void setMemoryBudget(qsizetype bytes);
+    bool fillUnwrittenArea();
+    void fillUndecodedArea();
+    bool cropImagetoSize();
+    void abortPage();
+    int completedRows() const;
+    bool sinkFailed() const;
+
+    using PixelConverter = void (*)(const uchar *source, uchar *destination, int units);
 
 private:
-    void renewImage();
-    void incrementPixelData();
+    using Decoder = bool (ImageBuilder::*)(const SANE_Byte readData[], int read_bytes);
+
+    static QImage::Format selectImageFormat(const SANE_Parameters &params, Interface::OutputFormat outputFormat);
+    static Decoder selectDecoder(const SANE_Parameters &params, QImage::Format imageFormat, bool invert);
+    template<int InputBytes, int OutputBytes, PixelConverter Convert>
+    bool decodePacked(const SANE_Byte readData[], int read_bytes);
+    template<int SampleBytes, int Channel, bool Invert>
+    bool decodePlanar(const SANE_Byte readData[], int read_bytes);
+    template<int SampleBytes, int Channel, bool Invert>
+    void scatterSamples(const SANE_Byte readData[], int read_bytes, uchar *bits);
+    uchar *currentRow();
+    void advance(int units);
+    qsizetype decodedBytes() const;
+    bool renewImage();
+    bool writeBand(int rows);
+    bool finishSinkPage();
+    bool endSinkPage(int height);
+    bool allocateImage(int width, int height, QImage::Format format);
+    void fillWhite(qsizetype from, qsizetype to);
+    bool resizeImage(int height);
 
     SANE_Parameters m_params;
-    int m_frameRead = 0;
-    int m_pixelX = 0;
+    Decoder m_decoder = nullptr;
+    qsizetype m_frameRead = 0;
+    // position in units of the decoder, pixels or bytes for line art
+    int m_rowUnits = 0;
+    int m_unitX = 0;
     int m_pixelY = 0;
-    int m_pixelData[6];
+    // pointer to the row m_pixelY, only valid during one copyToImage() call
+    uchar *m_row = nullptr;
+    SANE_Byte m_pixelData[6];
     int m_pixelDataIndex = 0;
+    // number of pixels of a three-pass image that have been set up by the first frame touching them
+    qsizetype m_initializedPixels = 0;
+    // the image has been finished, e.g. by fillUnwrittenArea()
+    bool m_imageComplete = false;
+    // the image has been filled up to this byte for showing it while scanning
+    qsizetype m_filledBytes = 0;
+    // end of the part of the image that has been handed out by directWriteBuffer()
+    qsizetype m_directWriteEnd = 0;
+    bool m_invertColors = false;
+    Interface::OutputFormat m_outputFormat = Interface::NativeOutputFormat;
+    QImage::Format m_imageFormat = QImage::Format_Invalid;
+    // the sink for the next pages and the sink of the current page until it has been ended
+    ScanSink *m_sink = nullptr;
+    ScanSink *m_pageSink = nullptr;
+    bool m_sinkFailed = false;
+    // the image only holds a band of rows, starting with the row m_bandOffset of the page
+    bool m_banded = false;
+    int m_bandOffset = 0;
 
     QImage *m_image;
+    std::shared_ptr<ImageBufferPool> m_bufferPool;
+    // the buffer backing m_image as long as the image has not been detached from it
+    std::weak_ptr<ImageBuffer> m_buffer;
     int *m_dpi;
 };
 
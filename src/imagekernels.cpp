@@ -0,0 +1,473 @@
+/*
+ * SPDX-FileCopyrightText: 2026 KSaneCore authors
+ *
+ * SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+ */
+
+#include "imagekernels.h"
+
+#include <QRgb>
+#include <QRgba64>
+
+#include <cstring>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define KSANE_KERNELS_SSE2
+#endif
+
+#if defined(KSANE_KERNELS_SSE2) && defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define KSANE_KERNELS_AVX2
+#endif
+
+#ifdef KSANE_KERNELS_SSE2
+#define SSE2_KERNEL(function, invert) function##Sse2<invert>
+#else
+#define SSE2_KERNEL(function, invert) nullptr
+#endif
+
+#ifdef KSANE_KERNELS_AVX2
+#define AVX2_KERNEL(function, invert) function##Avx2<invert>
+#else
+#define AVX2_KERNEL(function, invert) nullptr
+#endif
+
+namespace KSaneCore
+{
+namespace ImageKernels
+{
+
+// the inverting kernels flip all bits of the samples, but never the alpha channel
+static constexpr uchar sampleMask(bool invert)
+{
+    return invert ? 0xFF : 0x00;
+}
+
+static void xorBytesScalar(const uchar *source, uchar *destination, qsizetype bytes, quint64 pattern)
+{
+    for (qsizetype i = 0; i < bytes; i++) {
+        destination[i] = source[i] ^ uchar(pattern >> ((i % 8) * 8));
+    }
+}
+
+template<bool Invert>
+static void rgb8ToRgb32Scalar(const uchar *source, uchar *destination, int pixels)
+{
+    constexpr uchar mask = sampleMask(Invert);
+    QRgb *rgbData = reinterpret_cast<QRgb *>(destination);
+    for (int i = 0; i < pixels; i++, source += 3) {
+        rgbData[i] = qRgb(source[0] ^ mask, source[1] ^ mask, source[2] ^ mask);
+    }
+}
+
+template<bool Invert>
+static void rgb8ToGray8Scalar(const uchar *source, uchar *destination, int pixels)
+{
+    constexpr uchar mask = sampleMask(Invert);
+    for (int i = 0; i < pixels; i++, source += 3) {
+        destination[i] = qGray(source[0] ^ mask, source[1] ^ mask, source[2] ^ mask);
+    }
+}
+
+template<bool Invert>
+static void rgb16ToRgbx64Scalar(const uchar *source, uchar *destination, int pixels)
+{
+    constexpr quint16 mask = Invert ? 0xFFFF : 0x0000;
+    QRgba64 *rgbData = reinterpret_cast<QRgba64 *>(destination);
+    for (int i = 0; i < pixels; i++, source += 6) {
+        rgbData[i] = QRgba64::fromRgba64((source[0] + (source[1] << 8)) ^ mask,
+                                         (source[2] + (source[3] << 8)) ^ mask,
+                                         (source[4] + (source[5] << 8)) ^ mask,
+                                         0xFFFF);
+    }
+}
+
+template<bool Invert>
+static void scatterChannel8Scalar(const uchar *source, uchar *pixels, int channel, int samples)
+{
+    constexpr uchar mask = sampleMask(Invert);
+    pixels += channel;
+    for (int i = 0; i < samples; i++) {
+        pixels[i * 4] = source[i] ^ mask;
+    }
+}
+
+template<bool Invert>
+static void scatterChannel16Scalar(const uchar *source, uchar *pixels, int channel, int samples)
+{
+    constexpr uchar mask = sampleMask(Invert);
+    pixels += channel * 2;
+    for (int i = 0; i < samples; i++, source += 2, pixels += 8) {
+        pixels[0] = source[0] ^ mask;
+        pixels[1] = source[1] ^ mask;
+    }
+}
+
+#ifdef KSANE_KERNELS_SSE2
+static inline int load32(const uchar *source)
+{
+    int value;
+    memcpy(&value, source, sizeof(value));
+    return value;
+}
+
+static inline __m128i sampleMaskSse2(bool invert)
+{
+    return invert ? _mm_set1_epi32(-1) : _mm_setzero_si128();
+}
+
+static void xorBytesSse2(const uchar *source, uchar *destination, qsizetype bytes, quint64 pattern)
+{
+    const __m128i mask = _mm_set1_epi64x(static_cast<qint64>(pattern));
+    qsizetype i = 0;
+    for (; i + 16 <= bytes; i += 16) {
+        const __m128i data = _mm_loadu_si128(reinterpret_cast<const __m128i *>(source + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(destination + i), _mm_xor_si128(data, mask));
+    }
+    // i is a multiple of eight, so the pattern continues with its first byte
+    xorBytesScalar(source + i, destination + i, bytes - i, pattern);
+}
+
+template<bool Invert>
+static void rgb8ToRgb32Sse2(const uchar *source, uchar *destination, int pixels)
+{
+    const __m128i alpha = _mm_set1_epi32(static_cast<int>(0xFF000000));
+    const __m128i lowByte = _mm_set1_epi32(0x000000FF);
+    const __m128i secondByte = _mm_set1_epi32(0x0000FF00);
+    const __m128i mask = sampleMaskSse2(Invert);
+    int i = 0;
+    // every pixel is loaded with 32 bits, keep at least one spare byte behind the last pixel
+    for (; i + 5 <= pixels; i += 4, source += 12, destination += 16) {
+        const __m128i rgb = _mm_xor_si128(_mm_setr_epi32(load32(source), load32(source + 3), load32(source + 6), load32(source + 9)), mask);
+        const __m128i red = _mm_slli_epi32(_mm_and_si128(rgb, lowByte), 16);
+        const __m128i green = _mm_and_si128(rgb, secondByte);
+        const __m128i blue = _mm_and_si128(_mm_srli_epi32(rgb, 16), lowByte);
+        const __m128i pixel = _mm_or_si128(_mm_or_si128(red, green), _mm_or_si128(blue, alpha));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(destination), pixel);
+    }
+    rgb8ToRgb32Scalar<Invert>(source, destination, pixels - i);
+}
+
+static inline __m128i grayOfFourSse2(__m128i rgb)
+{
+    // weights of qGray() for red, green and blue, the fourth byte of every pixel is ignored
+    const __m128i weights = _mm_setr_epi16(11, 16, 5, 0, 11, 16, 5, 0);
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i low = _mm_madd_epi16(_mm_unpacklo_epi8(rgb, zero), weights);
+    const __m128i high = _mm_madd_epi16(_mm_unpackhi_epi8(rgb, zero), weights);
+    // add the red and green part to the blue part of each pixel
+    const __m128 redGreen = _mm_shuffle_ps(_mm_castsi128_ps(low), _mm_castsi128_ps(high), _MM_SHUFFLE(2, 0, 2, 0));
+    const __m128 blue = _mm_shuffle_ps(_mm_castsi128_ps(low), _mm_castsi128_ps(high), _MM_SHUFFLE(3, 1, 3, 1));
+    return _mm_srli_epi32(_mm_add_epi32(_mm_castps_si128(redGreen), _mm_castps_si128(blue)), 5);
+}
+
+template<bool Invert>
+static void rgb8ToGray8Sse2(const uchar *source, uchar *destination, int pixels)
+{
+    const __m128i mask = sampleMaskSse2(Invert);
+    int i = 0;
+    // every pixel is loaded with 32 bits, keep at least one spare byte behind the last pixel
+    for (; i + 9 <= pixels; i += 8, source += 24, destination += 8) {
+        const __m128i firstRgb = _mm_setr_epi32(load32(source), load32(source + 3), load32(source + 6), load32(source + 9));
+        const __m128i secondRgb = _mm_setr_epi32(load32(source + 12), load32(source + 15), load32(source + 18), load32(source + 21));
+        const __m128i first = grayOfFourSse2(_mm_xor_si128(firstRgb, mask));
+        const __m128i second = grayOfFourSse2(_mm_xor_si128(secondRgb, mask));
+        const __m128i gray = _mm_packs_epi32(first, second);
+        _mm_storel_epi64(reinterpret_cast<__m128i *>(destination), _mm_packus_epi16(gray, gray));
+    }
+    rgb8ToGray8Scalar<Invert>(source, destination, pixels - i);
+}
+
+template<bool Invert>
+static void rgb16ToRgbx64Sse2(const uchar *source, uchar *destination, int pixels)
+{
+    // the two bytes following each pixel end up in the alpha channel and are overwritten
+    const __m128i alpha = _mm_set1_epi64x(static_cast<qint64>(0xFFFF000000000000ULL));
+    const __m128i mask = sampleMaskSse2(Invert);
+    int i = 0;
+    for (; i + 3 <= pixels; i += 2, source += 12, destination += 16) {
+        const __m128i first = _mm_loadl_epi64(reinterpret_cast<const __m128i *>(source));
+        const __m128i second = _mm_loadl_epi64(reinterpret_cast<const __m128i *>(source + 6));
+        const __m128i pixel = _mm_xor_si128(_mm_unpacklo_epi64(first, second), mask);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(destination), _mm_or_si128(pixel, alpha));
+    }
+    rgb16ToRgbx64Scalar<Invert>(source, destination, pixels - i);
+}
+
+static inline void blendChannel(uchar *pixels, __m128i samples, __m128i mask)
+{
+    __m128i *destination = reinterpret_cast<__m128i *>(pixels);
+    const __m128i current = _mm_andnot_si128(mask, _mm_loadu_si128(destination));
+    _mm_storeu_si128(destination, _mm_or_si128(current, samples));
+}
+
+template<bool Invert>
+static void scatterChannel8Sse2(const uchar *source, uchar *pixels, int channel, int samples)
+{
+    const __m128i shift = _mm_cvtsi32_si128(channel * 8);
+    const __m128i mask = _mm_sll_epi32(_mm_set1_epi32(0xFF), shift);
+    const __m128i invert = sampleMaskSse2(Invert);
+    const __m128i zero = _mm_setzero_si128();
+    int i = 0;
+    for (; i + 16 <= samples; i += 16, source += 16, pixels += 64) {
+        const __m128i data = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i *>(source)), invert);
+        const __m128i low = _mm_unpacklo_epi8(data, zero);
+        const __m128i high = _mm_unpackhi_epi8(data, zero);
+        blendChannel(pixels, _mm_sll_epi32(_mm_unpacklo_epi16(low, zero), shift), mask);
+        blendChannel(pixels + 16, _mm_sll_epi32(_mm_unpackhi_epi16(low, zero), shift), mask);
+        blendChannel(pixels + 32, _mm_sll_epi32(_mm_unpacklo_epi16(high, zero), shift), mask);
+        blendChannel(pixels + 48, _mm_sll_epi32(_mm_unpackhi_epi16(high, zero), shift), mask);
+    }
+    scatterChannel8Scalar<Invert>(source, pixels, channel, samples - i);
+}
+
+template<bool Invert>
+static void scatterChannel16Sse2(const uchar *source, uchar *pixels, int channel, int samples)
+{
+    const __m128i shift = _mm_cvtsi32_si128(channel * 16);
+    const __m128i mask = _mm_sll_epi64(_mm_set1_epi64x(0xFFFF), shift);
+    const __m128i invert = sampleMaskSse2(Invert);
+    const __m128i zero = _mm_setzero_si128();
+    int i = 0;
+    for (; i + 8 <= samples; i += 8, source += 16, pixels += 64) {
+        const __m128i data = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i *>(source)), invert);
+        const __m128i low = _mm_unpacklo_epi16(data, zero);
+        const __m128i high = _mm_unpackhi_epi16(data, zero);
+        blendChannel(pixels, _mm_sll_epi64(_mm_unpacklo_epi32(low, zero), shift), mask);
+        blendChannel(pixels + 16, _mm_sll_epi64(_mm_unpackhi_epi32(low, zero), shift), mask);
+        blendChannel(pixels + 32, _mm_sll_epi64(_mm_unpacklo_epi32(high, zero), shift), mask);
+        blendChannel(pixels + 48, _mm_sll_epi64(_mm_unpackhi_epi32(high, zero), shift), mask);
+    }
+    scatterChannel16Scalar<Invert>(source, pixels, channel, samples - i);
+}
+#endif
+
+#ifdef KSANE_KERNELS_AVX2
+__attribute__((target("avx2"))) static inline __m256i sampleMaskAvx2(bool invert)
+{
+    return invert ? _mm256_set1_epi32(-1) : _mm256_setzero_si256();
+}
+
+__attribute__((target("avx2"))) static void xorBytesAvx2(const uchar *source, uchar *destination, qsizetype bytes, quint64 pattern)
+{
+    const __m256i mask = _mm256_set1_epi64x(static_cast<qint64>(pattern));
+    qsizetype i = 0;
+    for (; i + 32 <= bytes; i += 32) {
+        const __m256i data = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(source + i));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(destination + i), _mm256_xor_si256(data, mask));
+    }
+    // i is a multiple of eight, so the pattern continues with its first byte
+    xorBytesScalar(source + i, destination + i, bytes - i, pattern);
+}
+
+template<bool Invert>
+__attribute__((target("avx2"))) static void rgb8ToRgb32Avx2(const uchar *source, uchar *destination, int pixels)
+{
+    // each 128 bit lane converts four pixels from twelve bytes
+    const __m256i shuffle = _mm256_setr_epi8(2, 1, 0, -128, 5, 4, 3, -128, 8, 7, 6, -128, 11, 10, 9, -128,
+                                             2, 1, 0, -128, 5, 4, 3, -128, 8, 7, 6, -128, 11, 10, 9, -128);
+    const __m256i alpha = _mm256_set1_epi32(static_cast<int>(0xFF000000));
+    const __m256i mask = sampleMaskAvx2(Invert);
+    int i = 0;
+    // the upper lane loads 16 bytes from offset 12, keep four spare bytes behind the last pixel
+    for (; i + 10 <= pixels; i += 8, source += 24, destination += 32) {
+        const __m128i low = _mm_loadu_si128(reinterpret_cast<const __m128i *>(source));
+        const __m128i high = _mm_loadu_si128(reinterpret_cast<const __m128i *>(source + 12));
+        const __m256i rgb = _mm256_shuffle_epi8(_mm256_inserti128_si256(_mm256_castsi128_si256(low), high, 1), shuffle);
+        // inverting the alpha channel does not matter, it is set afterwards
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(destination), _mm256_or_si256(_mm256_xor_si256(rgb, mask), alpha));
+    }
+    rgb8ToRgb32Scalar<Invert>(source, destination, pixels - i);
+}
+
+template<bool Invert>
+__attribute__((target("avx2"))) static void rgb8ToGray8Avx2(const uchar *source, uchar *destination, int pixels)
+{
+    // each 128 bit lane extracts four pixels from twelve bytes, the weights of qGray() are applied per byte
+    const __m256i shuffle = _mm256_setr_epi8(0, 1, 2, -128, 3, 4, 5, -128, 6, 7, 8, -128, 9, 10, 11, -128,
+                                             0, 1, 2, -128, 3, 4, 5, -128, 6, 7, 8, -128, 9, 10, 11, -128);
+    const __m256i weights = _mm256_set1_epi32(0x0005100B);
+    const __m256i ones = _mm256_set1_epi16(1);
+    // the fourth byte of every pixel has a weight of zero, so it may be inverted as well
+    const __m256i mask = sampleMaskAvx2(Invert);
+    int i = 0;
+    // the upper lane loads 16 bytes from offset 12, keep four spare bytes behind the last pixel
+    for (; i + 10 <= pixels; i += 8, source += 24, destination += 8) {
+        const __m128i low = _mm_loadu_si128(reinterpret_cast<const __m128i *>(source));
+        const __m128i high = _mm_loadu_si128(reinterpret_cast<const __m128i *>(source + 12));
+        const __m256i rgb = _mm256_shuffle_epi8(_mm256_inserti128_si256(_mm256_castsi128_si256(low), high, 1), shuffle);
+        const __m256i sum = _mm256_madd_epi16(_mm256_maddubs_epi16(_mm256_xor_si256(rgb, mask), weights), ones);
+        const __m256i gray16 = _mm256_packs_epi32(_mm256_srli_epi32(sum, 5), _mm256_setzero_si256());
+        const __m256i gray8 = _mm256_packus_epi16(gray16, gray16);
+        const int first = _mm_cvtsi128_si32(_mm256_castsi256_si128(gray8));
+        const int second = _mm_cvtsi128_si32(_mm256_extracti128_si256(gray8, 1));
+        memcpy(destination, &first, sizeof(first));
+        memcpy(destination + 4, &second, sizeof(second));
+    }
+    rgb8ToGray8Scalar<Invert>(source, destination, pixels - i);
+}
+
+template<bool Invert>
+__attribute__((target("avx2"))) static void rgb16ToRgbx64Avx2(const uchar *source, uchar *destination, int pixels)
+{
+    // each 128 bit lane converts two pixels from twelve bytes
+    const __m256i shuffle = _mm256_setr_epi8(0, 1, 2, 3, 4, 5, -128, -128, 6, 7, 8, 9, 10, 11, -128, -128,
+                                             0, 1, 2, 3, 4, 5, -128, -128, 6, 7, 8, 9, 10, 11, -128, -128);
+    const __m256i alpha = _mm256_set1_epi64x(static_cast<qint64>(0xFFFF000000000000ULL));
+    const __m256i mask = sampleMaskAvx2(Invert);
+    int i = 0;
+    for (; i + 5 <= pixels; i += 4, source += 24, destination += 32) {
+        const __m128i low = _mm_loadu_si128(reinterpret_cast<const __m128i *>(source));
+        const __m128i high = _mm_loadu_si128(reinterpret_cast<const __m128i *>(source + 12));
+        const __m256i rgb = _mm256_shuffle_epi8(_mm256_inserti128_si256(_mm256_castsi128_si256(low), high, 1), shuffle);
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(destination), _mm256_or_si256(_mm256_xor_si256(rgb, mask), alpha));
+    }
+    rgb16ToRgbx64Scalar<Invert>(source, destination, pixels - i);
+}
+
+__attribute__((target("avx2"))) static inline void blendChannelAvx2(uchar *pixels, __m256i samples, __m256i mask)
+{
+    __m256i *destination = reinterpret_cast<__m256i *>(pixels);
+    const __m256i current = _mm256_andnot_si256(mask, _mm256_loadu_si256(destination));
+    _mm256_storeu_si256(destination, _mm256_or_si256(current, samples));
+}
+
+template<bool Invert>
+__attribute__((target("avx2"))) static void scatterChannel8Avx2(const uchar *source, uchar *pixels, int channel, int samples)
+{
+    const __m128i shift = _mm_cvtsi32_si128(channel * 8);
+    const __m256i mask = _mm256_sll_epi32(_mm256_set1_epi32(0xFF), shift);
+    const __m128i invert = sampleMaskSse2(Invert);
+    int i = 0;
+    for (; i + 16 <= samples; i += 16, source += 16, pixels += 64) {
+        const __m128i data = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i *>(source)), invert);
+        blendChannelAvx2(pixels, _mm256_sll_epi32(_mm256_cvtepu8_epi32(data), shift), mask);
+        blendChannelAvx2(pixels + 32, _mm256_sll_epi32(_mm256_cvtepu8_epi32(_mm_srli_si128(data, 8)), shift), mask);
+    }
+    scatterChannel8Scalar<Invert>(source, pixels, channel, samples - i);
+}
+
+template<bool Invert>
+__attribute__((target("avx2"))) static void scatterChannel16Avx2(const uchar *source, uchar *pixels, int channel, int samples)
+{
+    const __m128i shift = _mm_cvtsi32_si128(channel * 16);
+    const __m256i mask = _mm256_sll_epi64(_mm256_set1_epi64x(0xFFFF), shift);
+    const __m128i invert = sampleMaskSse2(Invert);
+    int i = 0;
+    for (; i + 8 <= samples; i += 8, source += 16, pixels += 64) {
+        const __m128i data = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i *>(source)), invert);
+        blendChannelAvx2(pixels, _mm256_sll_epi64(_mm256_cvtepu16_epi64(data), shift), mask);
+        blendChannelAvx2(pixels + 32, _mm256_sll_epi64(_mm256_cvtepu16_epi64(_mm_srli_si128(data, 8)), shift), mask);
+    }
+    scatterChannel16Scalar<Invert>(source, pixels, channel, samples - i);
+}
+#endif
+
+template<typename Function>
+static Function selectKernel(Function avx2, Function sse2, Function scalar)
+{
+#ifdef KSANE_KERNELS_AVX2
+    if (avx2 != nullptr && __builtin_cpu_supports("avx2")) {
+        return avx2;
+    }
+#endif
+    if (sse2 != nullptr) {
+        return sse2;
+    }
+    return scalar;
+}
+
+static XorFunction selectXorKernel()
+{
+#if defined(KSANE_KERNELS_AVX2)
+    return selectKernel<XorFunction>(xorBytesAvx2, xorBytesSse2, xorBytesScalar);
+#elif defined(KSANE_KERNELS_SSE2)
+    return xorBytesSse2;
+#else
+    return xorBytesScalar;
+#endif
+}
+
+void xorBytes(const uchar *source, uchar *destination, qsizetype bytes, quint64 pattern)
+{
+    static const XorFunction xorFunction = selectXorKernel();
+    xorFunction(source, destination, bytes, pattern);
+}
+
+template<bool Invert>
+void rgb8ToRgb32(const uchar *source, uchar *destination, int pixels)
+{
+    static const ConvertFunction convert =
+        selectKernel<ConvertFunction>(AVX2_KERNEL(rgb8ToRgb32, Invert), SSE2_KERNEL(rgb8ToRgb32, Invert), rgb8ToRgb32Scalar<Invert>);
+    convert(source, destination, pixels);
+}
+
+template<bool Invert>
+void rgb8ToGray8(const uchar *source, uchar *destination, int pixels)
+{
+    static const ConvertFunction convert =
+        selectKernel<ConvertFunction>(AVX2_KERNEL(rgb8ToGray8, Invert), SSE2_KERNEL(rgb8ToGray8, Invert), rgb8ToGray8Scalar<Invert>);
+    convert(source, destination, pixels);
+}
+
+template<bool Invert>
+void rgb16ToRgbx64(const uchar *source, uchar *destination, int pixels)
+{
+    static const ConvertFunction convert =
+        selectKernel<ConvertFunction>(AVX2_KERNEL(rgb16ToRgbx64, Invert), SSE2_KERNEL(rgb16ToRgbx64, Invert), rgb16ToRgbx64Scalar<Invert>);
+    convert(source, destination, pixels);
+}
+
+template<bool Invert>
+void scatterChannel8(const uchar *source, uchar *pixels, int channel, int samples)
+{
+    static const ScatterFunction scatter =
+        selectKernel<ScatterFunction>(AVX2_KERNEL(scatterChannel8, Invert), SSE2_KERNEL(scatterChannel8, Invert), scatterChannel8Scalar<Invert>);
+    scatter(source, pixels, channel, samples);
+}
+
+template<bool Invert>
+void scatterChannel16(const uchar *source, uchar *pixels, int channel, int samples)
+{
+    static const ScatterFunction scatter =
+        selectKernel<ScatterFunction>(AVX2_KERNEL(scatterChannel16, Invert), SSE2_KERNEL(scatterChannel16, Invert), scatterChannel16Scalar<Invert>);
+    scatter(source, pixels, channel, samples);
+}
+
+// the kernel set of the implementations with the given suffix
+#define KERNEL_SET(name, suffix)                                                                                                                               \
+    KernelSet                                                                                                                                                  \
+    {                                                                                                                                                          \
+        name, xorBytes##suffix, {rgb8ToRgb32##suffix<false>, rgb8ToRgb32##suffix<true>}, {rgb8ToGray8##suffix<false>, rgb8ToGray8##suffix<true>},               \
+            {rgb16ToRgbx64##suffix<false>, rgb16ToRgbx64##suffix<true>}, {scatterChannel8##suffix<false>, scatterChannel8##suffix<true>},                        \
+            {scatterChannel16##suffix<false>, scatterChannel16##suffix<true>}                                                                                 \
+    }
+
+QList<KernelSet> kernelSets()
+{
+    QList<KernelSet> sets = {KERNEL_SET("scalar", Scalar)};
+#ifdef KSANE_KERNELS_SSE2
+    sets.append(KERNEL_SET("sse2", Sse2));
+#endif
+#ifdef KSANE_KERNELS_AVX2
+    if (__builtin_cpu_supports("avx2")) {
+        sets.append(KERNEL_SET("avx2", Avx2));
+    }
+#endif
+    return sets;
+}
+
+template void rgb8ToRgb32<false>(const uchar *source, uchar *destination, int pixels);
+template void rgb8ToRgb32<true>(const uchar *source, uchar *destination, int pixels);
+template void rgb8ToGray8<false>(const uchar *source, uchar *destination, int pixels);
+template void rgb8ToGray8<true>(const uchar *source, uchar *destination, int pixels);
+template void rgb16ToRgbx64<false>(const uchar *source, uchar *destination, int pixels);
+template void rgb16ToRgbx64<true>(const uchar *source, uchar *destination, int pixels);
+template void scatterChannel8<false>(const uchar *source, uchar *pixels, int channel, int samples);
+template void scatterChannel8<true>(const uchar *source, uchar *pixels, int channel, int samples);
+template void scatterChannel16<false>(const uchar *source, uchar *pixels, int channel, int samples);
+template void scatterChannel16<true>(const uchar *source, uchar *pixels, int channel, int samples);
+
+} // namespace ImageKernels
+} // namespace KSaneCore
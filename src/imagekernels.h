@@ -0,0 +1,76 @@
+/*
+ * SPDX-FileCopyrightText: 2026 KSaneCore authors
+ *
+ * SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+ */
+
+#ifndef KSANE_IMAGE_KERNELS_H
+#define KSANE_IMAGE_KERNELS_H
+
+#include <QList>
+#include <QtGlobal>
+
+namespace KSaneCore
+{
+
+/* Row conversion kernels used by the ImageBuilder. The kernels convert
+ * a run of complete pixels and pick the fastest implementation
+ * supported by the CPU on first use. */
+namespace ImageKernels
+{
+
+/* XORs bytes with a pattern that repeats every eight bytes, starting with
+ * the lowest byte of pattern. An all ones pattern inverts the data. */
+void xorBytes(const uchar *source, uchar *destination, qsizetype bytes, quint64 pattern);
+
+/* The following kernels invert all samples while converting them if
+ * Invert is set, the alpha channel of the pixels remains opaque. */
+
+/* Converts packed 8 bit RGB samples to QImage::Format_RGB32 pixels */
+template<bool Invert>
+void rgb8ToRgb32(const uchar *source, uchar *destination, int pixels);
+
+/* Converts packed 8 bit RGB samples to QImage::Format_Grayscale8 pixels
+ * with the weights of qGray() */
+template<bool Invert>
+void rgb8ToGray8(const uchar *source, uchar *destination, int pixels);
+
+/* Converts packed 16 bit RGB samples to QImage::Format_RGBX64 pixels */
+template<bool Invert>
+void rgb16ToRgbx64(const uchar *source, uchar *destination, int pixels);
+
+/* Writes 8 bit samples of a single color plane into the byte with the
+ * index channel of consecutive Format_RGB32 pixels */
+template<bool Invert>
+void scatterChannel8(const uchar *source, uchar *pixels, int channel, int samples);
+
+/* Writes 16 bit samples of a single color plane into the 16 bit channel
+ * with the index channel of consecutive Format_RGBX64 pixels */
+template<bool Invert>
+void scatterChannel16(const uchar *source, uchar *pixels, int channel, int samples);
+
+using ConvertFunction = void (*)(const uchar *, uchar *, int);
+using ScatterFunction = void (*)(const uchar *, uchar *, int, int);
+using XorFunction = void (*)(const uchar *, uchar *, qsizetype, quint64);
+
+/* The implementations of all kernels for one instruction set, the arrays
+ * hold the kernel without and with Invert */
+struct KernelSet {
+    const char *name;
+    XorFunction xorBytes;
+    ConvertFunction rgb8ToRgb32[2];
+    ConvertFunction rgb8ToGray8[2];
+    ConvertFunction rgb16ToRgbx64[2];
+    ScatterFunction scatterChannel8[2];
+    ScatterFunction scatterChannel16[2];
+};
+
+/* Returns the kernel sets the CPU supports, starting with the scalar one,
+ * so that the autotests can compare the implementations with each other */
+QList<KernelSet> kernelSets();
+
+} // namespace ImageKernels
+
+} // namespace KSaneCore
+
+#endif // KSANE_IMAGE_KERNELS_H
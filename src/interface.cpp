@@ -15,6 +15,7 @@
 #include <QJsonObject>
 #include <QJsonValue>
 #include <QMetaEnum>
+#include <QMetaMethod>
 #include <QMutex>
 #include <QUrl>
 
@@ -94,6 +95,64 @@ void Interface::setPreviewResolution(float dpi)
     d->m_previewDPI = dpi;
 }
 
+void Interface::setOutputFormat(OutputFormat format)
+{
+    d->m_outputFormat = format;
+}
+
+Interface::OutputFormat Interface::outputFormat() const
+{
+    return d->m_outputFormat;
+}
+
+void Interface::setPageQueueDepth(int depth)
+{
+    d->m_pageQueueDepth = qMax(depth, 0);
+}
+
+int Interface::pageQueueDepth() const
+{
+    return d->m_pageQueueDepth;
+}
+
+void Interface::setScanSink(ScanSink *sink)
+{
+    d->m_scanSink = sink;
+}
+
+ScanSink *Interface::scanSink() const
+{
+    return d->m_scanSink;
+}
+
+void Interface::setImageMemoryBudget(qint64 bytes)
+{
+    d->m_imageMemoryBudget = qMax(bytes, qint64(0));
+}
+
+qint64 Interface::imageMemoryBudget() const
+{
+    return d->m_imageMemoryBudget;
+}
+
+void Interface::setReadChunkSize(int bytes)
+{
+    if (!d->m_saneHandle) {
+        return;
+    }
+    d->m_readChunkSizes.insert(d->m_devName, qBound(0, bytes, ReadSizeTuner::MaximumSize));
+}
+
+int Interface::readChunkSize() const
+{
+    return d->m_readChunkSizes.value(d->m_devName, SCAN_READ_CHUNK_SIZE);
+}
+
+ScanStatistics Interface::scanStatistics() const
+{
+    return d->m_scanStatistics;
+}
+
 bool Interface::reloadDevicesList(const DeviceType type)
 {
     /* On some SANE backends, the handle becomes invalid when
@@ -183,12 +242,11 @@ bool Interface::closeDevice()
     stopScan();
 
     disconnect(d->m_scanThread);
-    if (d->m_scanThread->isRunning()) {
-        connect(d->m_scanThread, &QThread::finished, d->m_scanThread, &QThread::deleteLater);
-    }
-    if (d->m_scanThread->isFinished()) {
-        d->m_scanThread->deleteLater();
-    }
+    // stopWorker() cancels a running scan, the handle must not be closed before the
+    // worker has returned from the backend, however long that takes
+    d->m_scanThread->stopWorker();
+    d->m_scanThread->wait();
+    d->m_scanThread->deleteLater();
     d->m_scanThread = nullptr;
 
     d->m_auth->clearDeviceAuth(d->m_devName);
@@ -212,7 +270,15 @@ void Interface::startScan()
     }
     d->m_optionPollTimer.stop();
     d->emitProgress(-1);
-    d->m_scanThread->start();
+    d->m_scanThread->setOutputFormat(d->m_previewScan ? NativeOutputFormat : d->m_outputFormat);
+    d->m_scanThread->setScanSink(d->m_previewScan ? nullptr : d->m_scanSink);
+    d->m_scanThread->setImageMemoryBudget(d->m_imageMemoryBudget);
+    d->m_scanThread->setReadChunkSize(readChunkSize());
+    // pages of a document feeder are scanned back to back by the scan thread
+    d->m_scanThread->setContinuousScanning(!d->m_previewScan && d->m_executeMultiPageScanning);
+    d->m_scanThread->setPageQueueDepth(d->m_pageQueueDepth);
+    d->m_scanThread->setPublishRows(isSignalConnected(QMetaMethod::fromSignal(&Interface::rowsAvailable)));
+    d->m_scanThread->startScan();
 }
 
 void Interface::startPreviewScan()
@@ -305,7 +371,7 @@ void Interface::stopScan()
     }
 
     d->m_cancelMultiPageScan = true;
-    if (d->m_scanThread->isRunning()) {
+    if (d->m_scanThread->isScanning()) {
         d->m_scanThread->cancelScan();
     }
     if (d->m_batchModeTimer.isActive()) {
@@ -416,7 +482,7 @@ QMap<QString, QString> Interface::getOptionsMap()
 
 int Interface::setOptionsMap(const QMap<QString, QString> &options)
 {
-    if (!d->m_saneHandle || d->m_scanThread->isRunning()) {
+    if (!d->m_saneHandle || d->m_scanThread->isScanning()) {
         return -1;
     }
 
@@ -20,6 +20,9 @@
 #include <QObject>
 
 #include "deviceinformation.h"
+#include "scannedpage.h"
+#include "scansink.h"
+#include "scanstatistics.h"
 
 namespace KSaneCore
 {
@@ -97,6 +100,18 @@ public:
      */
     enum DeviceType { AllDevices, NoCameraAndVirtualDevices };
 
+    /**
+     * This enumeration is used to select the image format of final scans
+     * with setOutputFormat(). The preference is applied to 8 bit color scans
+     * of single-pass scanners, all other scans use the native format.
+     * @since 26.12
+     */
+    enum OutputFormat {
+        NativeOutputFormat, // QImage::Format_RGB32 for 8 bit color scans
+        RGB888OutputFormat, // QImage::Format_RGB888 without padding bytes
+        Grayscale8OutputFormat, // QImage::Format_Grayscale8, converted with qGray()
+    };
+
     /**
      * This constructor initializes the private class variables.
      */
@@ -172,6 +187,106 @@ public:
      */
     void setPreviewResolution(float dpi);
 
+    /**
+     * This function is used to set the preferred image format of final scans.
+     * The image is written in this format while scanning, so no conversion
+     * of the finished image is needed. Preview scans always use the native format.
+     * @param format is the wanted output format
+     * @note the format is applied when the next scan is started.
+     * @since 26.12
+     */
+    void setOutputFormat(OutputFormat format);
+
+    /**
+     * @return the preferred image format of final scans set with setOutputFormat().
+     * @since 26.12
+     */
+    OutputFormat outputFormat() const;
+
+    /**
+     * This function is used to set how many pages of a document feeder may wait for
+     * the application while the following page is scanned already. Scanning continues
+     * at the speed of the feeder as long as the application keeps up on average, the
+     * feeder is paused once the given number of pages is waiting.
+     * @param depth is the number of waiting pages. Setting the value 0 means that the
+     * next page is requested after the application has handled the previous one.
+     * @note the depth is applied when the next scan is started.
+     * @since 26.12
+     */
+    void setPageQueueDepth(int depth);
+
+    /**
+     * @return the number of pages which may wait for the application, set with setPageQueueDepth().
+     * @since 26.12
+     */
+    int pageQueueDepth() const;
+
+    /**
+     * This function is used to pass the rows of final scans to a sink while scanning
+     * instead of building the image in memory. Only a band of rows is kept then, so pages
+     * of any size can be scanned. scannedImageReady(), scannedPageReady() and rowsAvailable()
+     * are not emitted for pages passed to the sink. Preview scans are not passed to the sink.
+     * @param sink is the sink or nullptr to build the images in memory again. The sink is
+     * not owned by the interface and has to stay valid until the scan has finished.
+     * @note the sink is applied when the next scan is started.
+     * @since 26.12
+     */
+    void setScanSink(ScanSink *sink);
+
+    /**
+     * @return the sink set with setScanSink() or nullptr.
+     * @since 26.12
+     */
+    ScanSink *scanSink() const;
+
+    /**
+     * This function is used to limit the memory used for the image of a page.
+     * Images which need more memory are built in a memory-mapped temporary file
+     * in the cache directory of the application instead, so that the system can
+     * page out the rows which have been scanned. If the file cannot be created,
+     * the image is built in memory. The images are delivered as usual, copying
+     * or converting them needs the full amount of memory though.
+     * @param bytes is the budget in bytes. Setting the value 0 means that all
+     * images are built in memory, which is the default.
+     * @note the budget is applied when the next scan is started.
+     * @since 26.12
+     */
+    void setImageMemoryBudget(qint64 bytes);
+
+    /**
+     * @return the memory budget of an image set with setImageMemoryBudget().
+     * @since 26.12
+     */
+    qint64 imageMemoryBudget() const;
+
+    /**
+     * This function is used to set the number of bytes requested from the opened
+     * device with a single read while scanning. Network backends usually transfer
+     * faster with large reads, while many USB backends return about one scan line
+     * per read regardless of the requested size.
+     * @param bytes is the wanted read size, at most 4 MiB. Setting the value 0 means
+     * that the size is tuned automatically during each scan by measuring the
+     * throughput of the first reads.
+     * @note the size is remembered for each device and applied when the next scan is started.
+     * @since 26.12
+     */
+    void setReadChunkSize(int bytes);
+
+    /**
+     * @return the read size of the opened device set with setReadChunkSize(),
+     * 0 if the size is tuned automatically.
+     * @since 26.12
+     */
+    int readChunkSize() const;
+
+    /**
+     * @return the timings of the last final page that has been scanned.
+     * The statistics are reset when a device is opened.
+     * @see scanStatisticsReady()
+     * @since 26.12
+     */
+    ScanStatistics scanStatistics() const;
+
     /**
      * This function returns all available options when a device is opened.
      * @return list containing pointers to all KSaneOptions provided by the backend.
@@ -218,6 +333,7 @@ public:
      * When accessing the direct image pointer during a scan, the image
      * must be locked before accessing the image and unlocked afterwards
      * using the lockScanImage() and unlockScanImage() functions.
+     * The rows which have not been scanned yet are white.
      * @return pointer for direct access of the QImage data.
      */
     QImage *scanImage() const;
@@ -293,6 +409,28 @@ Q_SIGNALS:
      */
     void scannedImageReady(const QImage &scannedImage);
 
+    /**
+     * This signal is emitted for each final page before scannedImageReady(),
+     * also for pages which are passed to a scan sink.
+     * @param statistics contains the timings of the page, the same as scanStatistics()
+     * @since 26.12
+     */
+    void scanStatisticsReady(const KSaneCore::ScanStatistics &statistics);
+
+    /**
+     * This signal is emitted after scannedImageReady() for the same final scan.
+     * The image of the page is shared with the copies of the image that
+     * receivers of scannedImageReady() have kept.
+     * @param page is the scanned page. A receiver takes ownership of the page
+     * by moving from it, e.g. with `ScannedPage myPage = std::move(page);`.
+     * Pages that are not taken are released when the signal returns, so the
+     * image memory can be reused for the next page of a batch scan.
+     * @note The page is only valid during the emission, so the signal must
+     * not be connected with a queued connection.
+     * @since 26.12
+     */
+    void scannedPageReady(KSaneCore::ScannedPage &page);
+
     /**
      * This signal is emitted when a preview scan is ready.
      * @param scannedImage is the QImage containing the scanned image data of the preview.
@@ -308,6 +446,14 @@ Q_SIGNALS:
      */
     void scanFinished(KSaneCore::Interface::ScanStatus status, const QString &strStatus);
 
+    /**
+     * This signal is emitted when a scan has stopped after it has been cancelled
+     * with stopScan(), before scanFinished() is emitted.
+     * @param milliseconds is the time from the call of stopScan() until the scanner had stopped.
+     * @since 26.12
+     */
+    void scanStopped(qint64 milliseconds);
+
     /**
      * This signal is emitted when the scanning for a preview has ended.
      * @param status contains a ScanStatus status code.
@@ -325,6 +471,24 @@ Q_SIGNALS:
      */
     void userMessage(KSaneCore::Interface::ScanStatus status, const QString &strStatus);
 
+    /**
+     * This signal is emitted while scanning whenever rows of the image have been completed.
+     * The rows are passed as a copy, by the time the signal is received the image of
+     * scanImage() might have been enlarged, handed over with scannedImageReady() or
+     * reused for the next page already. The signal is not emitted for pages which are
+     * passed to a sink set with setScanSink().
+     * @param frame is the index of the frame. Three-pass scanners send one frame per
+     * color channel, all other scanners only one frame.
+     * @param firstRow is the row of the image where the rows start
+     * @param rows contains the completed rows, one row of the image per row
+     * @note the rows are only copied if the signal is connected when the scan is started.
+     * @note changing the InvertColorOption while scanning also inverts the rows which have
+     * been completed already. Rows passed before the change keep their colors, the image of
+     * scannedImageReady() is inverted completely.
+     * @since 26.12
+     */
+    void rowsAvailable(int frame, int firstRow, const QImage &rows);
+
     /**
      * This signal is emitted for progress information during a scan.
      * @param percent is the percentage of the scan progress (0-100).
@@ -237,6 +237,7 @@ Interface::OpenStatus InterfacePrivate::loadDeviceOptions()
 
     // Create the scan thread
     m_scanThread = new ScanThread(m_saneHandle);
+    m_scanStatistics = ScanStatistics();
 
     m_scanThread->setImageInverted(invertOption->value());
     connect(invertOption, &InvertOption::valueChanged, m_scanThread, &ScanThread::setImageInverted);
@@ -247,7 +248,8 @@ Interface::OpenStatus InterfacePrivate::loadDeviceOptions()
     }
 
     connect(m_scanThread, &ScanThread::scanProgressUpdated, this, &InterfacePrivate::emitProgress);
-    connect(m_scanThread, &ScanThread::finished, this, &InterfacePrivate::imageScanFinished);
+    connect(m_scanThread, &ScanThread::rowsCompleted, q, &Interface::rowsAvailable);
+    connect(m_scanThread, &ScanThread::scanFinished, this, &InterfacePrivate::imageScanFinished);
 
     // try to set to default values
     setDefaultValues();
@@ -354,15 +356,42 @@ void InterfacePrivate::pollPollOptions()
 void InterfacePrivate::imageScanFinished()
 {
     emitProgress(100);
-    if (m_scanThread->frameStatus() == ScanThread::ReadReady) {
+    ScanThread::ScanResult result = m_scanThread->takeScanResult();
+    if (result.cancelLatency >= 0) {
+        qCDebug(KSANECORE_LOG) << "The scan has stopped" << result.cancelLatency << "ms after it has been cancelled";
+        Q_EMIT q->scanStopped(result.cancelLatency);
+    }
+    if (result.pageDropped) {
+        // stopScan() has ended scanning the document feeder after the previous page
+        scanIsFinished(Interface::NoError, QString());
+        return;
+    }
+    if (result.readStatus == ScanThread::ReadReady) {
         if (m_previewScan) {
             Q_EMIT q->previewImageReady(*m_scanThread->scanImage());
         } else {
-            Q_EMIT q->scannedImageReady(*m_scanThread->scanImage());
+            result.statistics.pageNsecs = result.pageTimer.nsecsElapsed();
+            m_scanStatistics = result.statistics;
+            qCDebug(KSANECORE_LOG) << "Page scanned in" << m_scanStatistics.pageNsecs / 1000000 << "ms," << m_scanStatistics.readCount << "reads of"
+                                   << m_scanStatistics.readBytes << "bytes in" << m_scanStatistics.readNsecs / 1000000 << "ms, decoded in"
+                                   << m_scanStatistics.decodeNsecs / 1000000 << "ms";
+            Q_EMIT q->scanStatisticsReady(m_scanStatistics);
+            // pages passed to a scan sink have been delivered while scanning
+            if (!result.passedToSink) {
+                // hand the image over, so the next page does not detach from it and starts with a recycled buffer
+                ScannedPage page(result.scanContinues ? std::move(result.image) : m_scanThread->takeScanImage());
+                Q_EMIT q->scannedImageReady(page.image());
+                Q_EMIT q->scannedPageReady(page);
+            }
+            // the scan thread continues with the next page of the document feeder on its own
+            if (result.scanContinues) {
+                m_scanThread->pageDelivered();
+                return;
+            }
             // now check if we should have automatic ADF batch scanning
             if (m_executeMultiPageScanning && !m_cancelMultiPageScan) {
                 emitProgress(-1);
-                m_scanThread->start();
+                m_scanThread->startScan();
                 return;
             }
             // check if we should have timed batch scanning
@@ -377,21 +406,21 @@ void InterfacePrivate::imageScanFinished()
             if (m_waitForExternalButton) {
                 qCDebug(KSANECORE_LOG) << "waiting for external button press to start next scan";
                 emitProgress(-1);
-                m_scanThread->start();
+                m_scanThread->startScan();
                 return;
             }
         }
         scanIsFinished(Interface::NoError, QString());
     } else {
-        switch (m_scanThread->saneStatus()) {
+        switch (result.saneStatus) {
         case SANE_STATUS_GOOD:
-            scanIsFinished(Interface::NoError, sane_i18n(sane_strstatus(m_scanThread->saneStatus())));
+            scanIsFinished(Interface::NoError, sane_i18n(sane_strstatus(result.saneStatus)));
             break;
         case SANE_STATUS_CANCELLED:
         case SANE_STATUS_EOF:
         case SANE_STATUS_NO_DOCS:
-            Q_EMIT q->userMessage(Interface::Information, sane_i18n(sane_strstatus(m_scanThread->saneStatus())));
-            scanIsFinished(Interface::Information, sane_i18n(sane_strstatus(m_scanThread->saneStatus())));
+            Q_EMIT q->userMessage(Interface::Information, sane_i18n(sane_strstatus(result.saneStatus)));
+            scanIsFinished(Interface::Information, sane_i18n(sane_strstatus(result.saneStatus)));
             break;
         case SANE_STATUS_UNSUPPORTED:
         case SANE_STATUS_IO_ERROR:
@@ -401,8 +430,8 @@ void InterfacePrivate::imageScanFinished()
         case SANE_STATUS_COVER_OPEN:
         case SANE_STATUS_DEVICE_BUSY:
         case SANE_STATUS_ACCESS_DENIED:
-            Q_EMIT q->userMessage(Interface::ErrorGeneral, sane_i18n(sane_strstatus(m_scanThread->saneStatus())));
-            scanIsFinished(Interface::ErrorGeneral, sane_i18n(sane_strstatus(m_scanThread->saneStatus())));
+            Q_EMIT q->userMessage(Interface::ErrorGeneral, sane_i18n(sane_strstatus(result.saneStatus)));
+            scanIsFinished(Interface::ErrorGeneral, sane_i18n(sane_strstatus(result.saneStatus)));
             break;
         }
     }
@@ -483,7 +512,7 @@ void InterfacePrivate::batchModeTimerUpdate()
         m_batchModeCounter = 0;
         if (m_scanThread != nullptr) {
             Q_EMIT q->scanProgress(-1);
-            m_scanThread->start();
+            m_scanThread->startScan();
         }
         m_batchModeTimer.stop();
     }
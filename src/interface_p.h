@@ -85,6 +85,15 @@ public:
     // determines whether a preview scan is carried out
     bool m_previewScan = false;
     float m_previewDPI = 50;
+    Interface::OutputFormat m_outputFormat = Interface::NativeOutputFormat;
+    // pages of a document feeder which may wait for the application
+    int m_pageQueueDepth = 2;
+    ScanSink *m_scanSink = nullptr;
+    qint64 m_imageMemoryBudget = 0;
+    // timings of the last final page
+    ScanStatistics m_scanStatistics;
+    // read sizes set for the devices, 0 for automatic tuning
+    QHash<QString, int> m_readChunkSizes;
     // determines whether scanner will send multiple images
     bool m_executeMultiPageScanning = false;
     // scanning has been cancelled externally
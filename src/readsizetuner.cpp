@@ -0,0 +1,100 @@
+/*
+ * SPDX-FileCopyrightText: 2026 KSaneCore authors
+ *
+ * SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+ */
+
+#include "readsizetuner.h"
+
+#include <ksanecore_debug.h>
+
+namespace KSaneCore
+{
+
+// a measurement covers at least this many reads and twice the read size or this much time
+static constexpr int SampleReads = 8;
+static constexpr qint64 SampleNsecs = 200 * 1000 * 1000;
+// a larger read size is only kept if it improves the throughput by 10%
+static constexpr double RequiredImprovement = 1.1;
+
+void ReadSizeTuner::setSize(int size)
+{
+    size = size > 0 ? qMin(size, MaximumSize) : 0;
+    if (size != m_size) {
+        m_size = size;
+        m_tunedSize = InitialSize;
+    }
+}
+
+int ReadSizeTuner::size() const
+{
+    return m_size;
+}
+
+int ReadSizeTuner::maximumSize() const
+{
+    return m_size > 0 ? m_size : MaximumSize;
+}
+
+void ReadSizeTuner::start()
+{
+    if (m_size > 0) {
+        m_readSize = m_size;
+        m_tuning = false;
+        return;
+    }
+    m_readSize = m_tunedSize;
+    m_tuning = true;
+    m_bestSize = 0;
+    m_bestThroughput = 0;
+    resetSample();
+}
+
+int ReadSizeTuner::readSize() const
+{
+    return m_readSize;
+}
+
+void ReadSizeTuner::addSample(int requestedBytes, int readBytes, qint64 nsecs)
+{
+    // reads limited by the end of the image say nothing about the read size
+    if (!m_tuning || requestedBytes != m_readSize || readBytes <= 0) {
+        return;
+    }
+    m_sampleReads++;
+    m_sampleBytes += readBytes;
+    m_sampleRequestedBytes += requestedBytes;
+    m_sampleNsecs += nsecs;
+    if (m_sampleReads < SampleReads || (m_sampleBytes < 2 * qint64(m_readSize) && m_sampleNsecs < SampleNsecs)) {
+        return;
+    }
+
+    const double throughput = double(m_sampleBytes) / qMax(m_sampleNsecs, qint64(1));
+    const bool improved = throughput > m_bestThroughput * RequiredImprovement;
+    if (improved) {
+        m_bestThroughput = throughput;
+        m_bestSize = m_readSize;
+    }
+    // backends which return less than requested do not profit from larger reads
+    const bool shortReads = m_sampleBytes < m_sampleRequestedBytes / 2;
+    if (improved && !shortReads && m_readSize < MaximumSize) {
+        m_readSize = qMin(m_readSize * 2, MaximumSize);
+        resetSample();
+        return;
+    }
+
+    m_readSize = m_bestSize;
+    m_tunedSize = m_bestSize;
+    m_tuning = false;
+    qCDebug(KSANECORE_LOG) << "Settled on a read size of" << m_readSize << "bytes," << m_bestThroughput * 1000 << "MB/s";
+}
+
+void ReadSizeTuner::resetSample()
+{
+    m_sampleReads = 0;
+    m_sampleBytes = 0;
+    m_sampleRequestedBytes = 0;
+    m_sampleNsecs = 0;
+}
+
+} // namespace KSaneCore
@@ -0,0 +1,53 @@
+/*
+ * SPDX-FileCopyrightText: 2026 KSaneCore authors
+ *
+ * SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+ */
+
+#ifndef KSANE_READ_SIZE_TUNER_H
+#define KSANE_READ_SIZE_TUNER_H
+
+#include <QtGlobal>
+
+namespace KSaneCore
+{
+
+/* Selects the number of bytes requested with one sane_read() call.
+ * The size is either set for the device or tuned automatically: starting
+ * from a moderate size, the size is doubled as long as the throughput of
+ * the reads improves notably, then the best size is kept for the rest of
+ * the scan and used as starting point for the next one. */
+class ReadSizeTuner
+{
+public:
+    static constexpr int InitialSize = 128 * 1024;
+    static constexpr int MaximumSize = 4 * 1024 * 1024;
+
+    /* 0 selects automatic tuning */
+    void setSize(int size);
+    int size() const;
+    /* the largest read size that may be requested during a scan */
+    int maximumSize() const;
+
+    void start();
+    int readSize() const;
+    void addSample(int requestedBytes, int readBytes, qint64 nsecs);
+
+private:
+    void resetSample();
+
+    int m_size = 0;
+    int m_readSize = InitialSize;
+    int m_tunedSize = InitialSize;
+    bool m_tuning = false;
+    int m_bestSize = 0;
+    double m_bestThroughput = 0;
+    int m_sampleReads = 0;
+    qint64 m_sampleBytes = 0;
+    qint64 m_sampleRequestedBytes = 0;
+    qint64 m_sampleNsecs = 0;
+};
+
+} // namespace KSaneCore
+
+#endif // KSANE_READ_SIZE_TUNER_H
@@ -0,0 +1,99 @@
+/*
+ * SPDX-FileCopyrightText: 2026 KSaneCore authors
+ *
+ * SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+ */
+
+#include "scanbufferring.h"
+
+#include <QMutexLocker>
+
+namespace KSaneCore
+{
+
+ScanBufferRing::ScanBufferRing(int chunkCount, int chunkSize)
+    : m_chunks(chunkCount)
+{
+    setChunkSize(chunkSize);
+}
+
+int ScanBufferRing::chunkSize() const
+{
+    return m_chunkSize;
+}
+
+void ScanBufferRing::setChunkSize(int chunkSize)
+{
+    if (chunkSize == m_chunkSize) {
+        return;
+    }
+    // release the old chunks first, the memory is only touched as far as it is read into
+    m_storage = QByteArray();
+    m_storage = QByteArray(qsizetype(m_chunks.size()) * chunkSize, Qt::Uninitialized);
+    m_chunkSize = chunkSize;
+    for (int i = 0; i < m_chunks.size(); i++) {
+        m_chunks[i].data = reinterpret_cast<SANE_Byte *>(m_storage.data()) + qsizetype(i) * chunkSize;
+    }
+}
+
+template<typename Predicate>
+void ScanBufferRing::waitFor(std::atomic<bool> &waiting, Predicate ready)
+{
+    if (ready()) {
+        return;
+    }
+    // The flag is set before the counter of the other side is checked again, and the other
+    // side checks the flag after it has changed its counter, so one of both sees the change.
+    QMutexLocker locker(&m_waitMutex);
+    waiting = true;
+    while (!ready()) {
+        m_waitCondition.wait(&m_waitMutex);
+    }
+    waiting = false;
+}
+
+void ScanBufferRing::wakeUp(const std::atomic<bool> &waiting)
+{
+    if (waiting) {
+        QMutexLocker locker(&m_waitMutex);
+        m_waitCondition.wakeAll();
+    }
+}
+
+ScanChunk *ScanBufferRing::writeChunk()
+{
+    const quint64 written = m_written.load(std::memory_order_relaxed);
+    waitFor(m_producerWaiting, [this, written]() {
+        return written - m_read < quint64(m_chunks.size());
+    });
+    return &m_chunks[written % m_chunks.size()];
+}
+
+void ScanBufferRing::commitWrite()
+{
+    writeChunk();
+    m_written = m_written.load(std::memory_order_relaxed) + 1;
+    wakeUp(m_consumerWaiting);
+}
+
+bool ScanBufferRing::isDrained() const
+{
+    return m_read == m_written.load(std::memory_order_relaxed);
+}
+
+ScanChunk *ScanBufferRing::readChunk()
+{
+    const quint64 read = m_read.load(std::memory_order_relaxed);
+    waitFor(m_consumerWaiting, [this, read]() {
+        return m_written != read;
+    });
+    return &m_chunks[read % m_chunks.size()];
+}
+
+void ScanBufferRing::releaseRead()
+{
+    m_read = m_read.load(std::memory_order_relaxed) + 1;
+    wakeUp(m_producerWaiting);
+}
+
+} // namespace KSaneCore
@@ -0,0 +1,89 @@
+/*
+ * SPDX-FileCopyrightText: 2026 KSaneCore authors
+ *
+ * SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+ */
+
+#ifndef KSANE_SCAN_BUFFER_RING_H
+#define KSANE_SCAN_BUFFER_RING_H
+
+extern "C"
+{
+#include <sane/sane.h>
+}
+
+#include <QByteArray>
+#include <QList>
+#include <QMutex>
+#include <QWaitCondition>
+
+#include <atomic>
+
+namespace KSaneCore
+{
+
+/* One entry of the ring: a chunk of data read with sane_read() or an
+ * event which the decoder has to handle in order with the data. */
+struct ScanChunk {
+    enum Type {
+        Data,
+        NewFrame,
+        FillUnwrittenArea,
+        CropImage,
+        EndOfScan,
+        StopDecoder
+    };
+
+    Type type = Data;
+    SANE_Byte *data = nullptr;
+    int size = 0;
+    // parameters of the frame for NewFrame
+    SANE_Parameters params;
+};
+
+/* Fixed ring of chunks handed from the thread reading from the scanner
+ * to the thread decoding the image. There is exactly one producer and one
+ * consumer, each side only advances its own counter. Passing a chunk takes
+ * no lock, a side only waits on the condition when the ring is full or
+ * empty and it has caught up with the other side. */
+class ScanBufferRing
+{
+public:
+    ScanBufferRing(int chunkCount, int chunkSize);
+
+    int chunkSize() const;
+    /* Reallocates the chunks, only allowed while the ring is drained */
+    void setChunkSize(int chunkSize);
+
+    /* Producer: returns the chunk to be filled next, waiting for a free one if necessary.
+     * The same chunk is returned until it is handed over with commitWrite(). */
+    ScanChunk *writeChunk();
+    void commitWrite();
+    /* Producer: true if the consumer has released all committed chunks */
+    bool isDrained() const;
+
+    /* Consumer: returns the oldest committed chunk, waiting for one if necessary */
+    ScanChunk *readChunk();
+    void releaseRead();
+
+private:
+    template<typename Predicate>
+    void waitFor(std::atomic<bool> &waiting, Predicate ready);
+    void wakeUp(const std::atomic<bool> &waiting);
+
+    QByteArray m_storage;
+    QList<ScanChunk> m_chunks;
+    int m_chunkSize = 0;
+    // number of chunks committed by the producer and released by the consumer so far
+    std::atomic<quint64> m_written = 0;
+    std::atomic<quint64> m_read = 0;
+    // only used by a side which has to wait for the other one
+    QMutex m_waitMutex;
+    QWaitCondition m_waitCondition;
+    std::atomic<bool> m_producerWaiting = false;
+    std::atomic<bool> m_consumerWaiting = false;
+};
+
+} // namespace KSaneCore
+
+#endif // KSANE_SCAN_BUFFER_RING_H
@@ -0,0 +1,51 @@
+/*
+ * SPDX-FileCopyrightText: 2026 KSaneCore authors
+ *
+ * SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+ */
+
+#include "scannedpage.h"
+
+namespace KSaneCore
+{
+
+class ScannedPagePrivate
+{
+public:
+    QImage image;
+};
+
+ScannedPage::ScannedPage() = default;
+
+ScannedPage::ScannedPage(QImage &&image) : d(std::make_unique<ScannedPagePrivate>())
+{
+    d->image = std::move(image);
+}
+
+ScannedPage::~ScannedPage() = default;
+
+ScannedPage::ScannedPage(ScannedPage &&other) noexcept = default;
+
+ScannedPage &ScannedPage::operator=(ScannedPage &&other) noexcept = default;
+
+bool ScannedPage::isNull() const
+{
+    return !d || d->image.isNull();
+}
+
+QImage ScannedPage::image() const
+{
+    return d ? d->image : QImage();
+}
+
+QImage ScannedPage::takeImage()
+{
+    if (!d) {
+        return QImage();
+    }
+    QImage image = std::move(d->image);
+    d.reset();
+    return image;
+}
+
+} // namespace KSaneCore
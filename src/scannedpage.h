@@ -0,0 +1,68 @@
+/*
+ * SPDX-FileCopyrightText: 2026 KSaneCore authors
+ *
+ * SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+ */
+
+#ifndef KSANE_SCANNEDPAGE_H
+#define KSANE_SCANNEDPAGE_H
+
+#include <memory>
+
+// Qt includes
+#include <QImage>
+
+#include "ksanecore_export.h"
+
+namespace KSaneCore
+{
+
+class ScannedPagePrivate;
+
+/**
+ * A scanned page handed over from the scanner to the application.
+ *
+ * The page is move-only, so taking the page out of
+ * KSaneCore::Interface::scannedPageReady() never copies the image.
+ * KSaneCore::Interface::scannedImageReady() is emitted before with a
+ * shared copy of the same image. Unless a receiver of that signal has kept
+ * the copy, the page is the only owner of the image data, otherwise
+ * modifying either image detaches it. Once the page and all copies of its
+ * image are destroyed, the image memory is reused for the following pages
+ * of a batch scan.
+ * @since 26.12
+ */
+class KSANECORE_EXPORT ScannedPage
+{
+
+public:
+    /** Constructs a null page */
+    ScannedPage();
+    ~ScannedPage();
+
+    ScannedPage(ScannedPage &&other) noexcept;
+    ScannedPage &operator=(ScannedPage &&other) noexcept;
+
+    ScannedPage(const ScannedPage &) = delete;
+    ScannedPage &operator=(const ScannedPage &) = delete;
+
+    /** @return true if the page holds no image, e.g. because it has been moved from */
+    bool isNull() const;
+
+    /** @return the image of the page, a null image for a null page */
+    QImage image() const;
+
+    /** Moves the image out of the page, which becomes a null page
+     * @return the image of the page */
+    QImage takeImage();
+
+private:
+    friend class InterfacePrivate;
+    explicit ScannedPage(QImage &&image);
+
+    std::unique_ptr<KSaneCore::ScannedPagePrivate> d;
+};
+
+} // namespace KSaneCore
+
+#endif // KSANE_SCANNEDPAGE_H
@@ -0,0 +1,18 @@
+/*
+ * SPDX-FileCopyrightText: 2026 KSaneCore authors
+ *
+ * SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+ */
+
+#include "scansink.h"
+
+namespace KSaneCore
+{
+
+ScanSink::~ScanSink() = default;
+
+void ScanSink::abortPage()
+{
+}
+
+} // namespace KSaneCore
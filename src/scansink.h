@@ -0,0 +1,76 @@
+/*
+ * SPDX-FileCopyrightText: 2026 KSaneCore authors
+ *
+ * SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+ */
+
+#ifndef KSANE_SCANSINK_H
+#define KSANE_SCANSINK_H
+
+// Qt includes
+#include <QImage>
+
+#include "ksanecore_export.h"
+
+namespace KSaneCore
+{
+
+/**
+ * A sink receives the rows of final scans while scanning, instead of a
+ * complete image of the page. It is set with KSaneCore::Interface::setScanSink().
+ *
+ * Only a band of rows is kept in memory, so pages which are larger than the
+ * available memory or exceed the limits of a single QImage can be streamed
+ * to storage. Three-pass scanners transfer
+ * one color channel of the whole page after the other, their pages are
+ * still assembled in memory and passed to the sink as a whole.
+ *
+ * If a function of the sink fails, the scan ends with the status
+ * SANE_STATUS_IO_ERROR.
+ *
+ * @note The functions are called from a scan thread.
+ * @since 26.12
+ */
+class KSANECORE_EXPORT ScanSink
+{
+
+public:
+    virtual ~ScanSink();
+
+    /**
+     * This function is called when a page starts.
+     * @param width is the width of the page in pixels
+     * @param height is the expected height of the page in pixels, -1 if the
+     * height is not known in advance, e.g. for hand scanners
+     * @param format is the format of the rows passed to writeRows()
+     * @param dpi is the resolution of the scan
+     * @return false to abort the scan
+     */
+    virtual bool beginPage(int width, int height, QImage::Format format, int dpi) = 0;
+
+    /**
+     * This function is called for the rows of the page in their order.
+     * @param firstRow is the index of the first of the rows within the page
+     * @param rows contains the rows. The buffer of the image is reused for the
+     * following rows, keeping a copy of the image makes the scan allocate a new one.
+     * @return false to abort the scan
+     */
+    virtual bool writeRows(int firstRow, const QImage &rows) = 0;
+
+    /**
+     * This function is called when all rows of the page have been written.
+     * @param height is the final height of the page in pixels
+     * @return false if the page could not be finished
+     */
+    virtual bool endPage(int height) = 0;
+
+    /**
+     * This function is called instead of endPage() if the scan of the page
+     * has failed or has been cancelled.
+     */
+    virtual void abortPage();
+};
+
+} // namespace KSaneCore
+
+#endif // KSANE_SCANSINK_H
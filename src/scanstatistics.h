@@ -0,0 +1,73 @@
+/*
+ * SPDX-FileCopyrightText: 2026 KSaneCore authors
+ *
+ * SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+ */
+
+#ifndef KSANE_SCANSTATISTICS_H
+#define KSANE_SCANSTATISTICS_H
+
+#include <array>
+
+// Qt includes
+#include <QtGlobal>
+
+namespace KSaneCore
+{
+
+/**
+ * Timings of a scanned page, from the start of the scanner until the page
+ * has been handed over to the application. All durations are in nanoseconds
+ * and include all frames of the page.
+ *
+ * The time spent in the SANE backend compared to the time spent decoding
+ * shows whether scanning is limited by the scanner or by the CPU.
+ * @since 26.12
+ */
+struct ScanStatistics {
+    /** Number of buckets of readLatencyHistogram */
+    static constexpr int ReadLatencyBuckets = 24;
+
+    /** Number of frames of the page, three for three-pass scanners */
+    int frames = 0;
+
+    /** Time spent in sane_start() */
+    qint64 startNsecs = 0;
+
+    /** Time spent in sane_get_parameters() */
+    qint64 getParametersNsecs = 0;
+
+    /** Number of sane_read() calls */
+    int readCount = 0;
+
+    /** Number of bytes returned by sane_read() */
+    qint64 readBytes = 0;
+
+    /** Time spent in sane_read() */
+    qint64 readNsecs = 0;
+
+    /** Shortest and longest sane_read() call */
+    qint64 readMinNsecs = 0;
+    qint64 readMaxNsecs = 0;
+
+    /**
+     * Distribution of the durations of the sane_read() calls. The first bucket
+     * counts the calls that took less than a microsecond, bucket i counts the
+     * calls that took at least 2^(i-1) and less than 2^i microseconds. The last
+     * bucket also counts all longer calls.
+     */
+    std::array<int, ReadLatencyBuckets> readLatencyHistogram = {};
+
+    /** Time spent building the image from the scanned data */
+    qint64 decodeNsecs = 0;
+
+    /** Time the scan threads and the application waited for the lock of the scanned image */
+    qint64 imageLockWaitNsecs = 0;
+
+    /** Time from the start of the page until it has been handed over to the application */
+    qint64 pageNsecs = 0;
+};
+
+} // namespace KSaneCore
+
+#endif // KSANE_SCANSTATISTICS_H
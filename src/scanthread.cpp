@@ -8,7 +8,10 @@
 
 #include "scanthread.h"
 
+#include <QElapsedTimer>
 #include <QMutexLocker>
+#include <QSocketNotifier>
+#include <QtAlgorithms>
 #include <QVariant>
 
 #include <ksanecore_debug.h>
@@ -17,21 +20,84 @@ namespace KSaneCore
 {
 
 ScanThread::ScanThread(SANE_Handle handle):
-    QThread(), m_saneHandle(handle), m_imageBuilder(&m_image, &m_dpi)
+    QThread(), m_bufferRing(SCAN_READ_CHUNK_COUNT, SCAN_READ_CHUNK_SIZE), m_saneHandle(handle), m_imageBuilder(&m_image, &m_dpi)
 {
     m_emitProgressUpdateTimer.setSingleShot(false);
     m_emitProgressUpdateTimer.setInterval(500);
     connect(&m_emitProgressUpdateTimer, &QTimer::timeout, this, &ScanThread::updateScanProgress);
-    connect(this, &QThread::started, &m_emitProgressUpdateTimer, QOverload<>::of(&QTimer::start));
     connect(this, &QThread::finished,&m_emitProgressUpdateTimer, &QTimer::stop);
 }
 
+void ScanThread::startScan()
+{
+    {
+        QMutexLocker locker(&m_jobMutex);
+        m_pendingScans++;
+        m_scanning = true;
+        m_cancelRequested = false;
+        m_jobCondition.wakeOne();
+    }
+    // the thread keeps running and waits for the next scan once a scan is finished
+    if (!isRunning()) {
+        start();
+    }
+    m_emitProgressUpdateTimer.start();
+}
+
+void ScanThread::setContinuousScanning(bool continuous)
+{
+    QMutexLocker locker(&m_jobMutex);
+    m_continuousScanning = continuous;
+}
+
+void ScanThread::setPageQueueDepth(int depth)
+{
+    QMutexLocker locker(&m_jobMutex);
+    m_pageQueueDepth = depth;
+    m_jobCondition.wakeOne();
+}
+
+void ScanThread::pageDelivered()
+{
+    QMutexLocker locker(&m_jobMutex);
+    m_undeliveredPages--;
+    m_jobCondition.wakeOne();
+}
+
+bool ScanThread::isScanning()
+{
+    QMutexLocker locker(&m_jobMutex);
+    return m_scanning;
+}
+
+void ScanThread::stopWorker()
+{
+    {
+        QMutexLocker locker(&m_jobMutex);
+        m_stopWorker = true;
+        m_continuousScanning = false;
+        m_jobCondition.wakeOne();
+        if (!m_scanning) {
+            return;
+        }
+    }
+    cancelScan();
+}
+
+ScanThread::ScanResult ScanThread::takeScanResult()
+{
+    QMutexLocker locker(&m_jobMutex);
+    return m_scanResults.isEmpty() ? ScanResult() : m_scanResults.takeFirst();
+}
+
 void ScanThread::setImageInverted(const QVariant &newValue)
 {
     const bool newInvert = newValue.toBool();
     if (m_invertColors != newInvert) {
+        QMutexLocker locker(&m_imageMutex);
         m_invertColors = newInvert;
-        m_image.invertPixels();
+        // also inverts the part of the image which has been scanned already
+        m_imageBuilder.setInvertColors(newInvert);
     }
 }
 
@@ -44,14 +110,34 @@ void ScanThread::setImageResolution(const QVariant &newValue)
     }
 }
 
-ScanThread::ReadStatus ScanThread::frameStatus()
+void ScanThread::setOutputFormat(Interface::OutputFormat format)
+{
+    // the worker might be between two scans, it applies the setting when it starts the next one
+    QMutexLocker locker(&m_jobMutex);
+    m_outputFormat = format;
+}
+
+void ScanThread::setScanSink(ScanSink *sink)
 {
-    return m_readStatus;
+    QMutexLocker locker(&m_jobMutex);
+    m_nextScanSink = sink;
 }
 
-SANE_Status ScanThread::saneStatus()
+void ScanThread::setImageMemoryBudget(qint64 bytes)
 {
-    return m_saneStatus;
+    QMutexLocker locker(&m_jobMutex);
+    m_imageMemoryBudget = bytes;
+}
+
+void ScanThread::setReadChunkSize(int bytes)
+{
+    QMutexLocker locker(&m_jobMutex);
+    m_readChunkSize = bytes;
+}
+
+void ScanThread::setPublishRows(bool publish)
+{
+    m_publishRows = publish;
 }
 
 QImage *ScanThread::scanImage()
@@ -62,6 +148,8 @@ QImage *ScanThread::scanImage()
 void ScanThread::lockScanImage()
 {
     m_imageMutex.lock();
+    // the application shows the image while scanning, the rows which have not been scanned yet are white
+    m_imageBuilder.fillUndecodedArea();
 }
 
 void ScanThread::unlockScanImage()
@@ -69,43 +157,166 @@ void ScanThread::unlockScanImage()
     m_imageMutex.unlock();
 }
 
+QImage ScanThread::takeScanImage()
+{
+    QMutexLocker locker(&m_imageMutex);
+    return std::move(m_image);
+}
+
 void ScanThread::cancelScan()
 {
-    m_readStatus = ReadCancel;
+    {
+        // also cancels a following page which has been started by continuous scanning
+        QMutexLocker locker(&m_jobMutex);
+        if (!m_cancelRequested) {
+            m_cancelTimer.start();
+        }
+        m_cancelRequested = true;
+        m_continuousScanning = false;
+        // a page which has been finished already is kept
+        endRead(ReadCancel);
+        m_jobCondition.wakeOne();
+    }
+    // makes a blocking sane_start() or sane_read() return
     sane_cancel(m_saneHandle);
+    // stops the event loop of the non-blocking read path
+    exitEventLoop();
+}
+
+void ScanThread::exitEventLoop()
+{
+    // exit() outside of exec() would end the next event loop right away, so it is only
+    // called once for an event loop which has been entered or is about to be entered
+    QMutexLocker locker(&m_jobMutex);
+    if (m_eventLoopRunning) {
+        m_eventLoopRunning = false;
+        exit();
+    }
 }
 
 void ScanThread::run()
+{
+    // this thread only reads from the device, the image is built by a second
+    // thread so that the device is not stalled while the data is converted
+    std::unique_ptr<QThread> decoderThread(QThread::create(&ScanThread::decodeData, this));
+    decoderThread->start();
+
+    QMutexLocker locker(&m_jobMutex);
+    while (true) {
+        // a following page of a document feeder is only scanned while at most m_pageQueueDepth
+        // finished pages are waiting for the application, with depth 0 it waits until the
+        // previous page has been handled
+        while ((m_pendingScans == 0 || (m_undeliveredPages > m_pageQueueDepth && m_continuedPage && !m_cancelRequested)) && !m_stopWorker) {
+            m_jobCondition.wait(&m_jobMutex);
+        }
+        if (m_stopWorker) {
+            break;
+        }
+        m_pendingScans--;
+        const bool continuedPage = m_continuedPage;
+        m_continuedPage = false;
+        m_readStatus = m_cancelRequested ? ReadCancel : ReadOngoing;
+        // the settings only change in between two pages
+        m_imageBuilder.setOutputFormat(m_outputFormat);
+        m_scanSink = m_nextScanSink;
+        m_imageBuilder.setSink(m_scanSink);
+        m_imageBuilder.setMemoryBudget(m_imageMemoryBudget);
+        m_readSizeTuner.setSize(m_readChunkSize);
+        locker.unlock();
+
+        const bool started = scanPage();
+
+        ScanResult result;
+        // the application has stopped scanning the document feeder before the next page has
+        // been requested from the device, the page is dropped without reporting a cancellation
+        result.pageDropped = continuedPage && !started;
+        result.readStatus = m_readStatus;
+        result.saneStatus = m_saneStatus;
+        result.passedToSink = m_scanSink != nullptr;
+        result.statistics = m_statistics;
+        result.statistics.imageLockWaitNsecs = m_imageMutex.takeWaitNsecs();
+        result.pageTimer = m_pageTimer;
+        locker.relock();
+        // only a page which has actually been stopped by the cancellation reports the latency,
+        // a page which has been finished before is delivered as usual
+        if (m_readStatus == ReadCancel && m_cancelTimer.isValid()) {
+            if (!result.pageDropped) {
+                result.cancelLatency = m_cancelTimer.elapsed();
+            }
+            m_cancelTimer.invalidate();
+        }
+        // Pages of an automatic document feeder are scanned one after the other without
+        // waiting for the application to handle the finished page. The image of the page
+        // is handed over with the result, so that the next page does not overwrite it.
+        if (m_readStatus == ReadReady && m_continuousScanning && !m_stopWorker) {
+            result.scanContinues = true;
+            m_undeliveredPages++;
+            m_pendingScans++;
+            m_continuedPage = true;
+            QMutexLocker imageLocker(&m_imageMutex);
+            result.image = std::move(m_image);
+        }
+        m_scanning = m_pendingScans > 0;
+        m_scanResults.append(result);
+        locker.unlock();
+        Q_EMIT scanFinished();
+        locker.relock();
+    }
+    m_scanning = false;
+    locker.unlock();
+
+    queueChunk(ScanChunk::StopDecoder);
+    decoderThread->wait();
+}
+
+bool ScanThread::scanPage()
 {
     m_dataSize = 0;
-    m_readStatus = ReadOngoing;
     m_announceFirstRead = true;
+    m_statistics = ScanStatistics();
+    m_pageTimer.start();
+    // waits for the image of the previous page do not count for this one
+    m_imageMutex.takeWaitNsecs();
+
+    if (m_readStatus == ReadCancel) {
+        m_saneStatus = SANE_STATUS_CANCELLED;
+        return false;
+    }
 
     // Start the scanning with sane_start
+    QElapsedTimer callTimer;
+    callTimer.start();
     m_saneStatus = sane_start(m_saneHandle);
+    m_statistics.startNsecs += callTimer.nsecsElapsed();
 
     if (m_readStatus == ReadCancel) {
-        return;
+        // the scan might have been cancelled before the device had been started
+        sane_cancel(m_saneHandle);
+        m_saneStatus = SANE_STATUS_CANCELLED;
+        return true;
     }
 
     if (m_saneStatus != SANE_STATUS_GOOD) {
         qCDebug(KSANECORE_LOG) << "sane_start=" << sane_strstatus(m_saneStatus);
         sane_cancel(m_saneHandle);
-        m_readStatus = ReadError;
-        return;
+        endRead(ReadError);
+        return true;
     }
 
     // Read image parameters
+    callTimer.restart();
     m_saneStatus = sane_get_parameters(m_saneHandle, &m_params);
+    m_statistics.getParametersNsecs += callTimer.nsecsElapsed();
     if (m_saneStatus != SANE_STATUS_GOOD) {
         qCDebug(KSANECORE_LOG) << "sane_get_parameters=" << sane_strstatus(m_saneStatus);
         sane_cancel(m_saneHandle);
-        m_readStatus = ReadError;
-        return;
+        endRead(ReadError);
+        return true;
     }
+    m_statistics.frames = 1;
 
     // calculate data size
-    m_frameSize  = m_params.lines * m_params.bytes_per_line;
+    m_frameSize  = qint64(m_params.lines) * m_params.bytes_per_line;
     if ((m_params.format == SANE_FRAME_RED) ||
             (m_params.format == SANE_FRAME_GREEN) ||
             (m_params.format == SANE_FRAME_BLUE)) {
@@ -115,23 +326,85 @@ void ScanThread::run()
         m_dataSize = m_frameSize;
     }
 
-    m_imageBuilder.start(m_params);
+    // the image, the parameters and the decoder are replaced while the application might
+    // access the image or change the color inversion
+    bool imageStarted;
+    {
+        QMutexLocker locker(&m_imageMutex);
+        imageStarted = m_imageBuilder.start(m_params);
+    }
+    if (!imageStarted) {
+        sane_cancel(m_saneHandle);
+        m_saneStatus = SANE_STATUS_NO_MEM;
+        endRead(ReadError);
+        return true;
+    }
+    m_readSizeTuner.start();
+    m_bufferRing.setChunkSize(m_readSizeTuner.maximumSize());
     m_frameRead = 0;
     m_frame_t_count = 0;
+    m_decodeFailed = false;
+    m_decodedFrame = 0;
+    m_completedRows = 0;
 
-    while (m_readStatus == ReadOngoing) {
-        readData();
+    while (m_readStatus == ReadOngoing && !m_decodeFailed) {
+        readFrame();
     }
+
+    // wait until the decoder has finished the image
+    queueChunk(ScanChunk::EndOfScan);
+    m_scanDecoded.acquire();
+    if (m_decodeFailed) {
+        // The reader has usually finished the page at the end of the data already, but the
+        // image could not be completed. Only a cancellation takes precedence over the error,
+        // which is an I/O error if the sink has failed, or else an image that could not be allocated.
+        ReadStatus status = m_readStatus;
+        while (status != ReadCancel && !m_readStatus.compare_exchange_weak(status, ReadError)) {
+        }
+        if (status != ReadCancel && (m_saneStatus == SANE_STATUS_GOOD || m_saneStatus == SANE_STATUS_EOF)) {
+            m_saneStatus = m_imageBuilder.sinkFailed() ? SANE_STATUS_IO_ERROR : SANE_STATUS_NO_MEM;
+        }
+    }
+    if (m_readStatus != ReadReady) {
+        QMutexLocker locker(&m_imageMutex);
+        m_imageBuilder.abortPage();
+    }
+    return true;
+}
+
+bool ScanThread::endRead(ReadStatus status)
+{
+    ReadStatus ongoing = ReadOngoing;
+    return m_readStatus.compare_exchange_strong(ongoing, status);
+}
+
+void ScanThread::addReadStatistics(qint64 nsecs, int readBytes)
+{
+    if (m_statistics.readCount == 0 || nsecs < m_statistics.readMinNsecs) {
+        m_statistics.readMinNsecs = nsecs;
+    }
+    m_statistics.readMaxNsecs = qMax(m_statistics.readMaxNsecs, nsecs);
+    m_statistics.readCount++;
+    m_statistics.readBytes += readBytes;
+    m_statistics.readNsecs += nsecs;
+    // bucket i counts durations of less than 2^i microseconds
+    const int bucket = 64 - qCountLeadingZeroBits(quint64(nsecs / 1000));
+    m_statistics.readLatencyHistogram[qMin(bucket, ScanStatistics::ReadLatencyBuckets - 1)]++;
 }
 
 void ScanThread::updateScanProgress()
 {
+    if (!isScanning()) {
+        m_emitProgressUpdateTimer.stop();
+        return;
+    }
+
     // handscanners have negative data size
     if (m_dataSize <= 0) {
         return;
     }
 
-    int bytesRead;
+    qint64 bytesRead;
 
     if (m_frameSize < m_dataSize) {
         bytesRead = m_frameRead + (m_frameSize * m_frame_t_count);
@@ -140,14 +413,82 @@ void ScanThread::updateScanProgress()
     }
 
     if (bytesRead > 0) {
-        Q_EMIT scanProgressUpdated(static_cast<int>((static_cast<float>(bytesRead) * 100.0) / m_dataSize));
+        Q_EMIT scanProgressUpdated(static_cast<int>((static_cast<double>(bytesRead) * 100.0) / m_dataSize));
+    }
+}
+
+void ScanThread::readFrame()
+{
+    const int frame = m_frame_t_count;
+    const auto frameOngoing = [this, frame]() {
+        return m_readStatus == ReadOngoing && !m_decodeFailed && m_frame_t_count == frame;
+    };
+
+    // Backends supporting non-blocking I/O are only read when data is available. The thread
+    // waits in its event loop instead of in sane_read(), so cancelScan() can wake it up at once.
+    SANE_Int selectFd = -1;
+    if (sane_set_io_mode(m_saneHandle, SANE_TRUE) == SANE_STATUS_GOOD) {
+        if (sane_get_select_fd(m_saneHandle, &selectFd) == SANE_STATUS_GOOD) {
+            QSocketNotifier notifier(selectFd, QSocketNotifier::Read);
+            connect(&notifier, &QSocketNotifier::activated, &notifier, [this, &frameOngoing]() {
+                // read until the backend has no more data at hand
+                qint64 frameRead;
+                do {
+                    frameRead = m_frameRead;
+                    readData();
+                } while (m_frameRead != frameRead && frameOngoing());
+                if (!frameOngoing()) {
+                    exitEventLoop();
+                }
+            });
+            bool enterEventLoop;
+            {
+                // a cancellation before this point has ended the frame already
+                QMutexLocker locker(&m_jobMutex);
+                enterEventLoop = frameOngoing();
+                m_eventLoopRunning = enterEventLoop;
+            }
+            if (enterEventLoop) {
+                exec();
+            }
+            if (m_readStatus == ReadCancel) {
+                m_saneStatus = SANE_STATUS_CANCELLED;
+            }
+            return;
+        }
+        sane_set_io_mode(m_saneHandle, SANE_FALSE);
+    }
+
+    while (frameOngoing()) {
+        readData();
     }
 }
 
 void ScanThread::readData()
 {
     SANE_Int readBytes = 0;
-    m_saneStatus = sane_read(m_saneHandle, m_readData, SCAN_READ_CHUNK_SIZE, &readBytes);
+    const int readSize = m_readSizeTuner.readSize();
+    int maxBytes = readSize;
+    m_directBuffer = nullptr;
+    if (m_bufferRing.isDrained()) {
+        // gray and line art data can be read straight into the image rows,
+        // but only once the decoder has caught up with the data read before
+        QMutexLocker locker(&m_imageMutex);
+        m_directBuffer = m_imageBuilder.directWriteBuffer(&maxBytes);
+    }
+    SANE_Byte *readBuffer = m_directBuffer;
+    if (m_directBuffer == nullptr) {
+        maxBytes = readSize;
+        readBuffer = m_bufferRing.writeChunk()->data;
+    }
+    QElapsedTimer readTimer;
+    readTimer.start();
+    m_saneStatus = sane_read(m_saneHandle, readBuffer, maxBytes, &readBytes);
+    const qint64 readNsecs = readTimer.nsecsElapsed();
+    addReadStatistics(readNsecs, readBytes);
+    if (m_saneStatus == SANE_STATUS_GOOD) {
+        m_readSizeTuner.addSample(maxBytes, readBytes, readNsecs);
+    }
 
     if (readBytes > 0 && m_announceFirstRead) {
         Q_EMIT scanProgressUpdated(0);
@@ -168,43 +509,52 @@ void ScanThread::readData()
                 copyToScanData(readBytes);
             }
             // There are broken backends that return wrong number for bytes_per_line
-            if (m_params.depth == 1 && m_params.lines > 0 && m_params.lines * m_params.pixels_per_line <= m_frameRead * 8) {
+            if (m_params.depth == 1 && m_params.lines > 0 && qint64(m_params.lines) * m_params.pixels_per_line <= m_frameRead * 8) {
                 qCDebug(KSANECORE_LOG) << "Warning!! This backend seems to return wrong bytes_per_line for line-art images!";
                 qCDebug(KSANECORE_LOG) << "Warning!! Trying to correct the value!";
-                m_params.bytes_per_line = m_frameRead / m_params.lines;
+                m_params.bytes_per_line = SANE_Int(m_frameRead / m_params.lines);
             }
-            m_readStatus = ReadReady; // It is better to return a broken image than nothing
+            queueChunk(ScanChunk::FillUnwrittenArea);
+            endRead(ReadReady); // It is better to return a broken image than nothing
             return;
         }
         if (m_params.last_frame == SANE_TRUE) {
             // this is where it all ends well :)
-            m_imageBuilder.cropImagetoSize();
-            m_readStatus = ReadReady;
+            queueChunk(ScanChunk::CropImage);
+            endRead(ReadReady);
             return;
         } else {
             // start reading next frame
+            QElapsedTimer callTimer;
+            callTimer.start();
             m_saneStatus = sane_start(m_saneHandle);
+            m_statistics.startNsecs += callTimer.nsecsElapsed();
             if (m_saneStatus != SANE_STATUS_GOOD) {
                 qCDebug(KSANECORE_LOG) << "sane_start =" << sane_strstatus(m_saneStatus);
-                m_readStatus = ReadError;
+                endRead(ReadError);
                 return;
             }
+            callTimer.restart();
             m_saneStatus = sane_get_parameters(m_saneHandle, &m_params);
+            m_statistics.getParametersNsecs += callTimer.nsecsElapsed();
             if (m_saneStatus != SANE_STATUS_GOOD) {
                 qCDebug(KSANECORE_LOG) << "sane_get_parameters =" << sane_strstatus(m_saneStatus);
-                m_readStatus = ReadError;
+                endRead(ReadError);
                 sane_cancel(m_saneHandle);
                 return;
             }
             //qCDebug(KSANECORE_LOG) << "New Frame";
-            m_imageBuilder.beginFrame(m_params);
+            m_bufferRing.writeChunk()->params = m_params;
+            queueChunk(ScanChunk::NewFrame);
             m_frameRead = 0;
             m_frame_t_count++;
-            break;
+            m_statistics.frames++;
+            // the chunk which has been read into now carries the new frame
+            return;
         }
     default:
         qCDebug(KSANECORE_LOG) << "sane_read=" << m_saneStatus << "=" << sane_strstatus(m_saneStatus);
-        m_readStatus = ReadError;
+        endRead(ReadError);
         sane_cancel(m_saneHandle);
         return;
     }
@@ -214,29 +564,85 @@ void ScanThread::readData()
 
 void ScanThread::copyToScanData(int readBytes)
 {
-    if (m_invertColors) {
-        if (m_params.depth == 16) {
-            //if (readBytes%2) qCDebug(KSANECORE_LOG) << "readBytes=" << readBytes;
-            quint16 *u16ptr = reinterpret_cast<quint16 *>(m_readData);
-            for (int i = 0; i < readBytes / 2; i++) {
-                u16ptr[i] = 0xFFFF - u16ptr[i];
-            }
-        } else if (m_params.depth == 8) {
-            for (int i = 0; i < readBytes; i++) {
-                m_readData[i] = 0xFF - m_readData[i];
+    if (m_directBuffer != nullptr) {
+        QMutexLocker locker(&m_imageMutex);
+        QElapsedTimer decodeTimer;
+        decodeTimer.start();
+        m_imageBuilder.commitDirectWrite(readBytes);
+        publishRows();
+        m_statistics.decodeNsecs += decodeTimer.nsecsElapsed();
+    } else if (readBytes > 0) {
+        m_bufferRing.writeChunk()->size = readBytes;
+        queueChunk(ScanChunk::Data);
+    }
+    m_frameRead += readBytes;
+}
+
+void ScanThread::queueChunk(ScanChunk::Type type)
+{
+    m_bufferRing.writeChunk()->type = type;
+    m_bufferRing.commitWrite();
+}
+
+void ScanThread::publishRows()
+{
+    // Called with m_imageMutex locked. The rows are copied, until the queued signal is delivered
+    // the image might be handed over, enlarged or replaced by the next page.
+    const int firstRow = m_completedRows;
+    m_completedRows = m_imageBuilder.completedRows();
+    if (m_completedRows > firstRow && m_publishRows) {
+        Q_EMIT rowsCompleted(m_decodedFrame, firstRow, m_image.copy(0, firstRow, m_image.width(), m_completedRows - firstRow));
+    }
+}
+
+void ScanThread::decodeData()
+{
+    bool stop = false;
+    while (!stop) {
+        const ScanChunk *chunk = m_bufferRing.readChunk();
+        {
+            QMutexLocker locker(&m_imageMutex);
+            QElapsedTimer decodeTimer;
+            decodeTimer.start();
+            switch (chunk->type) {
+            case ScanChunk::Data:
+                // after an error, the remaining data is only drained
+                if (!m_decodeFailed && !m_imageBuilder.copyToImage(chunk->data, chunk->size)) {
+                    m_decodeFailed = true;
+                }
+                publishRows();
+                break;
+            case ScanChunk::NewFrame:
+                m_imageBuilder.beginFrame(chunk->params);
+                m_decodedFrame++;
+                m_completedRows = 0;
+                break;
+            case ScanChunk::FillUnwrittenArea:
+                if (!m_decodeFailed && !m_imageBuilder.fillUnwrittenArea()) {
+                    m_decodeFailed = true;
+                }
+                publishRows();
+                break;
+            case ScanChunk::CropImage:
+                if (!m_decodeFailed && !m_imageBuilder.cropImagetoSize()) {
+                    m_decodeFailed = true;
+                }
+                break;
+            case ScanChunk::EndOfScan:
+                // the reading thread waits for the end of the page and takes the time spent on it
+                m_statistics.decodeNsecs += m_decodeNsecs;
+                m_decodeNsecs = 0;
+                m_scanDecoded.release();
+                break;
+            case ScanChunk::StopDecoder:
+                stop = true;
+                break;
             }
-        } else if (m_params.depth == 1) {
-            for (int i = 0; i < readBytes; i++) {
-                m_readData[i] = ~m_readData[i];
+            if (chunk->type != ScanChunk::EndOfScan) {
+                m_decodeNsecs += decodeTimer.nsecsElapsed();
             }
         }
-    }
-
-    QMutexLocker locker(&m_imageMutex);
-    if (m_imageBuilder.copyToImage(m_readData, readBytes)) {
-        m_frameRead += readBytes;
-    } else {
-        m_readStatus = ReadError;
+        m_bufferRing.releaseRead();
     }
 }
 
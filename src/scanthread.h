@@ -10,6 +10,9 @@
 #define KSANE_SCAN_THREAD_H
 
 #include "imagebuilder.h"
+#include "readsizetuner.h"
+#include "scanbufferring.h"
+#include "scanstatistics.h"
 
 // Sane includes
 extern "C"
@@ -19,16 +22,53 @@ extern "C"
 }
 
 #include <QThread>
+#include <QList>
 #include <QMutex>
+#include <QSemaphore>
 #include <QByteArray>
+#include <QElapsedTimer>
 #include <QImage>
 #include <QTimer>
+#include <QWaitCondition>
+
+#include <atomic>
 
 #define SCAN_READ_CHUNK_SIZE 100000
+#define SCAN_READ_CHUNK_COUNT 4
 
 namespace KSaneCore
 {
 
+/* A mutex which sums up the time spent waiting for it */
+class TimedMutex
+{
+public:
+    void lock()
+    {
+        if (!m_mutex.tryLock()) {
+            QElapsedTimer timer;
+            timer.start();
+            m_mutex.lock();
+            m_waitNsecs += timer.nsecsElapsed();
+        }
+    }
+
+    void unlock()
+    {
+        m_mutex.unlock();
+    }
+
+    /* Returns the time spent waiting since the last call */
+    qint64 takeWaitNsecs()
+    {
+        return m_waitNsecs.exchange(0);
+    }
+
+private:
+    QMutex m_mutex;
+    std::atomic<qint64> m_waitNsecs = 0;
+};
+
 class ScanThread: public QThread
 {
     Q_OBJECT
@@ -40,45 +80,130 @@ public:
         ReadReady
     };
 
+    /* Result of a finished scan. The image is only set if the scan continues with the
+     * next page of a document feeder, otherwise the image is taken with takeScanImage().
+     * No image is built if the page has been passed to a scan sink. */
+    struct ScanResult {
+        ReadStatus readStatus = ReadError;
+        SANE_Status saneStatus = SANE_STATUS_GOOD;
+        QImage image;
+        bool scanContinues = false;
+        // a following page of a document feeder which has been stopped before it was started
+        bool pageDropped = false;
+        bool passedToSink = false;
+        // milliseconds from cancelScan() until the scan had stopped, -1 if it has not been cancelled
+        qint64 cancelLatency = -1;
+        // the end-to-end time of the page is completed when the page is delivered
+        ScanStatistics statistics;
+        QElapsedTimer pageTimer;
+    };
+
     explicit ScanThread(SANE_Handle handle);
     void run() override;
+    void startScan();
+    void setContinuousScanning(bool continuous);
+    void setPageQueueDepth(int depth);
+    void pageDelivered();
+    bool isScanning();
+    void stopWorker();
     void setImageInverted(const QVariant &newValue);
     void setImageResolution(const QVariant &newValue);
+    void setOutputFormat(Interface::OutputFormat format);
+    void setScanSink(ScanSink *sink);
+    void setImageMemoryBudget(qint64 bytes);
+    void setReadChunkSize(int bytes);
+    void setPublishRows(bool publish);
     void cancelScan();
 
-    ReadStatus frameStatus();
-    SANE_Status saneStatus();
+    ScanResult takeScanResult();
 
     void lockScanImage();
     QImage *scanImage();
     void unlockScanImage();
+    QImage takeScanImage();
 
 Q_SIGNALS:
 
     void scanProgressUpdated(int progress);
+    void scanFinished();
+    void rowsCompleted(int frame, int firstRow, const QImage &rows);
 
 private:
+    // returns false if the page has been cancelled before the device has been started
+    bool scanPage();
+    void readFrame();
     void readData();
+    void decodeData();
     void updateScanProgress();
     void copyToScanData(int readBytes);
-
-    SANE_Byte       m_readData[SCAN_READ_CHUNK_SIZE];
+    void queueChunk(ScanChunk::Type type);
+    void publishRows();
+    bool endRead(ReadStatus status);
+    void exitEventLoop();
+    void addReadStatistics(qint64 nsecs, int readBytes);
+
+    ScanBufferRing  m_bufferRing;
+    ReadSizeTuner   m_readSizeTuner;
+    // the image row data is read into, null when reading into the ring
+    SANE_Byte      *m_directBuffer = nullptr;
     SANE_Handle     m_saneHandle;
-    int             m_frameSize = 0;
-    int             m_frameRead = 0;
+    qint64          m_frameSize = 0;
+    qint64          m_frameRead = 0;
     int             m_frame_t_count = 0;
-    int             m_dataSize = 0;
+    qint64          m_dataSize = 0;
     int             m_dpi = 0;
     SANE_Parameters m_params;
     SANE_Status     m_saneStatus = SANE_STATUS_GOOD;
-    ReadStatus      m_readStatus = ReadReady;
+    // The state of the page is changed by the worker and by cancelScan(). An ongoing page ends
+    // exactly once, with the first change to ReadReady, ReadError or ReadCancel.
+    std::atomic<ReadStatus> m_readStatus = ReadReady;
     bool            m_announceFirstRead = true;
     bool            m_invertColors = false;
+    std::atomic<bool> m_decodeFailed = false;
+    // frame and rows of the image which have been completed, guarded by m_imageMutex
+    int             m_decodedFrame = 0;
+    int             m_completedRows = 0;
+    // copies of the completed rows are only made if somebody receives them
+    std::atomic<bool> m_publishRows = false;
     ImageBuilder    m_imageBuilder;
+    // the sink of the current scan
+    ScanSink       *m_scanSink = nullptr;
     QImage          m_image;
-    QMutex          m_imageMutex;
+    TimedMutex      m_imageMutex;
+
+    // statistics of the page, collected by the reading thread
+    ScanStatistics  m_statistics;
+    QElapsedTimer   m_pageTimer;
+    // time spent decoding by the decoder thread, added to the statistics at the end of the page
+    qint64          m_decodeNsecs = 0;
 
     QTimer          m_emitProgressUpdateTimer;
+
+    // scan jobs of the worker, guarded by m_jobMutex
+    QMutex          m_jobMutex;
+    QWaitCondition  m_jobCondition;
+    // settings applied by the worker when it starts the next scan
+    Interface::OutputFormat m_outputFormat = Interface::NativeOutputFormat;
+    ScanSink       *m_nextScanSink = nullptr;
+    qint64          m_imageMemoryBudget = 0;
+    int             m_readChunkSize = SCAN_READ_CHUNK_SIZE;
+    int             m_pendingScans = 0;
+    bool            m_scanning = false;
+    bool            m_continuousScanning = false;
+    // the pending scan has been queued for the following page of a continuous scan
+    bool            m_continuedPage = false;
+    // pages of a continuous scan which have not been handled by the application yet
+    int             m_undeliveredPages = 0;
+    int             m_pageQueueDepth = 0;
+    bool            m_cancelRequested = false;
+    // started by cancelScan() and read when the scan has stopped
+    QElapsedTimer   m_cancelTimer;
+    bool            m_stopWorker = false;
+    // the worker waits in its event loop for data of a non-blocking backend
+    bool            m_eventLoopRunning = false;
+    QList<ScanResult> m_scanResults;
+    // released by the decoder when it has handled the end of a scan
+    QSemaphore      m_scanDecoded;
 };
 
 } // namespace KSaneCore